@@ -0,0 +1,322 @@
+#include "batch_pipeline.h"
+#include "brick_index.h"
+#include "marching_cube_flying_edges.h"
+#include "marching_cube_serial.h"
+#include "mesh_sink.h"
+#include "src/metrics.h"
+#include "src/volume_io.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Volumen leído, pendiente de extraer
+struct BatchPipeline::LoadedVolume
+{
+    std::string path;
+    Volume field;
+    size_t bytes = 0;
+};
+
+// Malla extraída, pendiente de escribir
+struct BatchPipeline::ExtractedMesh
+{
+    std::string path;
+    int nx = 0, ny = 0, nz = 0;
+    std::vector<Triangle> triangles;
+    size_t bytes = 0;
+    double extractMs = 0.0;
+};
+
+BatchPipeline::BatchPipeline(const BatchOptions &options)
+    : options(options), wallMs(0.0), totalTriangles(0)
+{
+}
+
+// Archivos .bin de un directorio (ordenados), o el propio archivo
+std::vector<std::string> BatchPipeline::listInputs(const std::string &path)
+{
+    std::vector<std::string> inputs;
+    std::error_code error;
+    if (!std::filesystem::is_directory(path, error))
+    {
+        inputs.push_back(path);
+        return inputs;
+    }
+
+    for (const auto &entry : std::filesystem::directory_iterator(path, error))
+    {
+        if (entry.is_regular_file(error) && entry.path().extension() == ".bin")
+        {
+            inputs.push_back(entry.path().string());
+        }
+    }
+    if (error)
+    {
+        std::cerr << "Error: No se pudo leer el directorio " << path << std::endl;
+    }
+    std::sort(inputs.begin(), inputs.end());
+    return inputs;
+}
+
+// Ruta de salida: <outputDir>/<nombre sin .bin>.<formato>
+std::string BatchPipeline::outputPath(const std::string &input) const
+{
+    std::filesystem::path name = std::filesystem::path(input).stem();
+    name += "." + options.format;
+    return (std::filesystem::path(options.outputDir) / name).string();
+}
+
+// Etapa 1: lectura. Reserva la memoria del volumen (según la cabecera) antes
+// de asignarla, de modo que nunca hay más volúmenes en memoria de los que
+// admite la cola. El único límite de tamaño es volumeMemoryBytes: un volumen
+// mayor no cabría nunca en la cola y se descarta
+void BatchPipeline::loadStage(const std::vector<std::string> &inputs, BoundedQueue<LoadedVolume> &volumes)
+{
+    StageStats &stats = stages[0];
+    for (const std::string &path : inputs)
+    {
+        int nx, ny, nz;
+        if (!readVolumeHeader(path, nx, ny, nz))
+        {
+            stats.failed++;
+            continue;
+        }
+        size_t bytes = static_cast<size_t>(nx) * ny * nz * sizeof(float);
+        if (bytes > options.volumeMemoryBytes)
+        {
+            std::cerr << "Error: " << path << " ocupa " << (bytes >> 20) << " MB, más que el límite de "
+                      << (options.volumeMemoryBytes >> 20) << " MB para volúmenes" << std::endl;
+            stats.failed++;
+            continue;
+        }
+
+        auto waitStart = Clock::now();
+        volumes.reserve(bytes);
+        stats.waitOutputMs += elapsedMs(waitStart);
+
+        auto start = Clock::now();
+        LoadedVolume item;
+        item.path = path;
+        item.bytes = bytes;
+        bool loaded = readVolumeFile(item.field, path);
+        stats.busyMs += elapsedMs(start);
+
+        if (!loaded)
+        {
+            volumes.cancel(bytes);
+            stats.failed++;
+            continue;
+        }
+        MC_METRIC_ADD(BYTES_READ, sizeof(int) * 3 + bytes);
+        volumes.push(std::move(item));
+        stats.items++;
+    }
+    volumes.close();
+}
+
+// Etapa 2: extracción con el motor elegido. La malla ya está en memoria cuando
+// se conoce su tamaño, así que la contrapresión detiene la extracción del
+// siguiente volumen hasta que el escritor libera sitio
+void BatchPipeline::extractStage(BoundedQueue<LoadedVolume> &volumes, BoundedQueue<ExtractedMesh> &meshes)
+{
+    StageStats &stats = stages[1];
+    MarchingCubesSerial engine;
+    MarchingCubesFlyingEdges flyingEdges;
+    BrickIndex bricks;
+    engine.setIsoValue(options.isoValue);
+    flyingEdges.setIsoValue(options.isoValue);
+
+    for (;;)
+    {
+        LoadedVolume volume;
+        auto waitStart = Clock::now();
+        bool more = volumes.pop(volume);
+        stats.waitInputMs += elapsedMs(waitStart);
+        if (!more)
+        {
+            break;
+        }
+
+        auto start = Clock::now();
+        ExtractedMesh mesh;
+        mesh.path = volume.path;
+        mesh.nx = volume.field.nx();
+        mesh.ny = volume.field.ny();
+        mesh.nz = volume.field.nz();
+        if (options.backend == ExtractionBackend::FLYING_EDGES)
+        {
+            flyingEdges.setScalarField(volume.field.data(), mesh.nx, mesh.ny, mesh.nz);
+            flyingEdges.generateIsosurface(mesh.triangles);
+        }
+        else
+        {
+            // Flying Edges ya recorta cada fila a su tramo activo; el motor
+            // cubo a cubo salta los bricks que no contienen el isovalor
+            bricks.build(volume.field.data(), mesh.nx, mesh.ny, mesh.nz);
+            engine.setScalarField(volume.field.data(), mesh.nx, mesh.ny, mesh.nz);
+            engine.setBrickIndex(&bricks);
+            engine.generateIsosurface(mesh.triangles);
+        }
+        mesh.bytes = mesh.triangles.size() * sizeof(Triangle);
+        mesh.extractMs = elapsedMs(start);
+        stats.busyMs += mesh.extractMs;
+
+        // El volumen ya no hace falta: se libera antes de esperar
+        volume.field.release();
+        volumes.release(volume.bytes);
+
+        waitStart = Clock::now();
+        meshes.reserve(mesh.bytes);
+        stats.waitOutputMs += elapsedMs(waitStart);
+        meshes.push(std::move(mesh));
+        stats.items++;
+    }
+    meshes.close();
+}
+
+// Etapa 3: escritura de cada malla en su archivo
+void BatchPipeline::writeStage(BoundedQueue<ExtractedMesh> &meshes)
+{
+    StageStats &stats = stages[2];
+    for (;;)
+    {
+        ExtractedMesh mesh;
+        auto waitStart = Clock::now();
+        bool more = meshes.pop(mesh);
+        stats.waitInputMs += elapsedMs(waitStart);
+        if (!more)
+        {
+            break;
+        }
+
+        auto start = Clock::now();
+        bool written = true;
+        if (!options.outputDir.empty())
+        {
+            std::string path = outputPath(mesh.path);
+            std::unique_ptr<MeshSink> sink;
+            if (options.format == "ply")
+            {
+                std::unique_ptr<BinaryPlySink> ply(new BinaryPlySink());
+                written = ply->open(path);
+                sink.reset(ply.release());
+            }
+            else
+            {
+                std::unique_ptr<BinaryStlSink> stl(new BinaryStlSink());
+                written = stl->open(path);
+                sink.reset(stl.release());
+            }
+            if (written)
+            {
+                sink->addTriangles(mesh.triangles.data(), mesh.triangles.size());
+                written = sink->finish();
+            }
+        }
+        size_t count = mesh.triangles.size();
+        std::vector<Triangle>().swap(mesh.triangles);
+        meshes.release(mesh.bytes);
+        stats.busyMs += elapsedMs(start);
+
+        if (!written)
+        {
+            stats.failed++;
+            continue;
+        }
+        totalTriangles += count;
+        stats.items++;
+        std::cout << "[batch] " << mesh.path << " (" << mesh.nx << "x" << mesh.ny << "x" << mesh.nz
+                  << "): " << count << " triangles, extract " << std::fixed << std::setprecision(1)
+                  << mesh.extractMs << " ms" << std::defaultfloat << std::endl;
+    }
+}
+
+// Lanza las tres etapas y espera a que terminen
+bool BatchPipeline::run(const std::vector<std::string> &inputs)
+{
+    stages.assign(3, StageStats());
+    stages[0].name = "load";
+    stages[1].name = "extract";
+    stages[2].name = "write";
+    totalTriangles = 0;
+
+    if (!options.outputDir.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(options.outputDir, error);
+        if (error)
+        {
+            std::cerr << "Error: No se pudo crear el directorio " << options.outputDir << std::endl;
+            return false;
+        }
+    }
+
+    BoundedQueue<LoadedVolume> volumes(options.queueDepth, options.volumeMemoryBytes);
+    BoundedQueue<ExtractedMesh> meshes(options.queueDepth, options.meshMemoryBytes);
+
+    auto start = Clock::now();
+    std::thread loader(&BatchPipeline::loadStage, this, std::cref(inputs), std::ref(volumes));
+    std::thread extractor(&BatchPipeline::extractStage, this, std::ref(volumes), std::ref(meshes));
+    writeStage(meshes);
+    extractor.join();
+    loader.join();
+    wallMs = elapsedMs(start);
+
+    return getFailures() == 0;
+}
+
+int BatchPipeline::getFailures() const
+{
+    int failures = 0;
+    for (const StageStats &stage : stages)
+    {
+        failures += stage.failed;
+    }
+    return failures;
+}
+
+// Utilización de cada etapa: la más cercana al 100% limita el rendimiento;
+// las demás pasan el resto del tiempo esperando entrada o sitio en la salida
+void BatchPipeline::printReport() const
+{
+    std::cout << "\n=== BATCH PIPELINE ===\n";
+    std::cout << std::left << std::setw(10) << "Stage" << std::right
+              << std::setw(8) << "Items" << std::setw(12) << "Busy ms" << std::setw(8) << "Util"
+              << std::setw(14) << "Starved ms" << std::setw(14) << "Blocked ms" << "\n";
+
+    const StageStats *bottleneck = nullptr;
+    double serialMs = 0.0;
+    for (const StageStats &stage : stages)
+    {
+        double utilisation = wallMs > 0.0 ? 100.0 * stage.busyMs / wallMs : 0.0;
+        std::cout << std::left << std::setw(10) << stage.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(8) << stage.items << std::setw(12) << stage.busyMs
+                  << std::setw(7) << utilisation << "%" << std::setw(14) << stage.waitInputMs
+                  << std::setw(14) << stage.waitOutputMs << "\n";
+        serialMs += stage.busyMs;
+        if (!bottleneck || stage.busyMs > bottleneck->busyMs)
+        {
+            bottleneck = &stage;
+        }
+    }
+
+    std::cout << "Wall time: " << wallMs << " ms (sequential stages: " << serialMs << " ms, overlap "
+              << (wallMs > 0.0 ? serialMs / wallMs : 0.0) << "x)\n";
+    if (bottleneck)
+    {
+        std::cout << "Bottleneck: " << bottleneck->name << "\n";
+    }
+    std::cout << "Triangles: " << totalTriangles << ", failures: " << getFailures() << "\n"
+              << std::defaultfloat;
+}
@@ -0,0 +1,199 @@
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Cola acotada entre dos etapas del pipeline, con límite de elementos y de
+// memoria. El productor reserva sitio (reserve) antes de crear el elemento,
+// de modo que la memoria queda acotada antes de asignarla; el consumidor
+// devuelve los bytes (release) cuando termina de usar el elemento, así que el
+// límite cubre también el elemento que se está procesando. Si no hay nada
+// reservado se admite siempre un elemento, aunque supere el límite, para que
+// el pipeline no se bloquee con elementos grandes (mallas).
+template <typename T>
+class BoundedQueue
+{
+public:
+    BoundedQueue(size_t maxItems, size_t maxBytes)
+        : maxItems(maxItems > 0 ? maxItems : 1), maxBytes(maxBytes), slots(0), bytes(0), closed(false)
+    {
+    }
+
+    // Espera hasta que haya sitio para un elemento de 'size' bytes y lo
+    // reserva (contrapresión sobre el productor)
+    void reserve(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] {
+            return slots < maxItems && (bytes == 0 || bytes + size <= maxBytes);
+        });
+        slots++;
+        bytes += size;
+    }
+
+    // Encola un elemento ya reservado
+    void push(T &&item)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.push_back(std::move(item));
+        }
+        changed.notify_all();
+    }
+
+    // Saca el siguiente elemento; false cuando la cola está cerrada y vacía
+    bool pop(T &item)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return closed || !items.empty(); });
+        if (items.empty())
+        {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        slots--;
+        lock.unlock();
+        changed.notify_all();
+        return true;
+    }
+
+    // Anula una reserva que no llegó a encolarse
+    void cancel(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots--;
+            bytes -= size;
+        }
+        changed.notify_all();
+    }
+
+    // Devuelve los bytes de un elemento ya procesado
+    void release(size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bytes -= size;
+        }
+        changed.notify_all();
+    }
+
+    // El productor no enviará más elementos
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        changed.notify_all();
+    }
+
+private:
+    size_t maxItems;
+    size_t maxBytes;
+    size_t slots;
+    size_t bytes;
+    bool closed;
+    std::deque<T> items;
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+// Motor de extracción de cada trabajo
+enum class ExtractionBackend
+{
+    MARCHING_CUBES, // MarchingCubesSerial, cubo a cubo
+    FLYING_EDGES    // MarchingCubesFlyingEdges, por filas y en paralelo
+};
+
+// Opciones del procesado por lotes
+struct BatchOptions
+{
+    // Isovalor común a todos los volúmenes
+    float isoValue;
+
+    // Motor de extracción
+    ExtractionBackend backend;
+
+    // Directorio de salida y formato ("stl" o "ply"); sin directorio las
+    // mallas solo se cuentan
+    std::string outputDir;
+    std::string format;
+
+    // Elementos en cola entre etapas (volúmenes cargados, mallas generadas)
+    size_t queueDepth;
+
+    // Memoria máxima de los volúmenes cargados y de las mallas pendientes
+    // de escribir (cada límite por separado). Un volumen mayor que
+    // volumeMemoryBytes se descarta como fallo de lectura
+    size_t volumeMemoryBytes;
+    size_t meshMemoryBytes;
+
+    BatchOptions()
+        : isoValue(0.0f), backend(ExtractionBackend::MARCHING_CUBES), format("stl"), queueDepth(2),
+          volumeMemoryBytes(size_t(2) << 30), meshMemoryBytes(size_t(1) << 30) {}
+};
+
+// Tiempos de una etapa del pipeline
+struct StageStats
+{
+    const char *name;
+    int items;           // volúmenes procesados
+    int failed;          // volúmenes con error en esta etapa
+    double busyMs;       // tiempo trabajando
+    double waitInputMs;  // esperando a la etapa anterior (etapa con hambre)
+    double waitOutputMs; // esperando sitio en la cola siguiente (contrapresión)
+};
+
+// Procesa una lista de archivos .bin en tres etapas concurrentes: mientras se
+// lee el volumen N+1 se extrae la isosuperficie del N y se escribe la malla
+// del N-1. Cada etapa corre en su propio hilo (la carga y la extracción
+// pueden usar además OpenMP internamente) y se comunica con la siguiente por
+// una BoundedQueue. La utilización de cada etapa (tiempo ocupado / tiempo
+// total) indica cuál es el cuello de botella.
+class BatchPipeline
+{
+public:
+    explicit BatchPipeline(const BatchOptions &options);
+
+    // Procesa los archivos en orden. Devuelve false si alguno falló (los
+    // demás se procesan igualmente)
+    bool run(const std::vector<std::string> &inputs);
+
+    // Resultados de la última ejecución
+    const std::vector<StageStats> &getStageStats() const { return stages; }
+    double getWallMs() const { return wallMs; }
+    long long getTotalTriangles() const { return totalTriangles; }
+    int getFailures() const;
+
+    // Imprime la utilización de cada etapa
+    void printReport() const;
+
+    // Archivos .bin de un directorio (ordenados), o el propio archivo
+    static std::vector<std::string> listInputs(const std::string &path);
+
+private:
+    // Elementos que circulan entre etapas
+    struct LoadedVolume;
+    struct ExtractedMesh;
+
+    void loadStage(const std::vector<std::string> &inputs, BoundedQueue<LoadedVolume> &volumes);
+    void extractStage(BoundedQueue<LoadedVolume> &volumes, BoundedQueue<ExtractedMesh> &meshes);
+    void writeStage(BoundedQueue<ExtractedMesh> &meshes);
+
+    // Ruta de salida de la malla de 'input'
+    std::string outputPath(const std::string &input) const;
+
+    BatchOptions options;
+    std::vector<StageStats> stages;
+    double wallMs;
+    long long totalTriangles;
+};
+
+#endif // BATCH_PIPELINE_H
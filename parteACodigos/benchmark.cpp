@@ -0,0 +1,166 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Celdas procesadas por segundo según la mediana
+double BenchmarkResult::cellsPerSecond() const
+{
+    if (stats.medianMs <= 0.0)
+    {
+        return 0.0;
+    }
+    double cells = static_cast<double>(std::max(sizeX - 1, 0)) * std::max(sizeY - 1, 0) * std::max(sizeZ - 1, 0);
+    return cells / (stats.medianMs * 1e-3);
+}
+
+// Percentil por el método del rango más cercano
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    rank = std::min(std::max<size_t>(rank, 1), sorted.size());
+    return sorted[rank - 1];
+}
+
+// Calcula las estadísticas de una lista de tiempos
+BenchmarkStats computeStats(std::vector<double> samplesMs)
+{
+    BenchmarkStats stats;
+    if (samplesMs.empty())
+    {
+        return stats;
+    }
+
+    std::sort(samplesMs.begin(), samplesMs.end());
+    size_t n = samplesMs.size();
+
+    stats.minMs = samplesMs.front();
+    stats.maxMs = samplesMs.back();
+    stats.medianMs = (n % 2) ? samplesMs[n / 2] : 0.5 * (samplesMs[n / 2 - 1] + samplesMs[n / 2]);
+    stats.p95Ms = percentile(samplesMs, 0.95);
+
+    double sum = 0.0;
+    for (double s : samplesMs)
+    {
+        sum += s;
+    }
+    stats.meanMs = sum / n;
+    return stats;
+}
+
+// Ejecuta calentamiento + ejecuciones medidas
+BenchmarkResult runBenchmark(const BenchmarkConfig &config,
+                             const std::function<long long()> &body)
+{
+    BenchmarkResult result;
+    result.warmupRuns = std::max(config.warmupRuns, 0);
+    result.runs = std::max(config.runs, 1);
+
+    for (int i = 0; i < result.warmupRuns; i++)
+    {
+        result.triangles = body();
+    }
+
+    for (int i = 0; i < result.runs; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        result.triangles = body();
+        auto end = std::chrono::steady_clock::now();
+        result.samplesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    result.stats = computeStats(result.samplesMs);
+    return result;
+}
+
+// Escapa una cadena para JSON
+static std::string jsonString(const std::string &text)
+{
+    std::string out = "\"";
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        default:
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Exporta los resultados como un arreglo JSON
+bool writeResultsJson(const std::vector<BenchmarkResult> &results, const std::string &filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+
+    file << std::setprecision(6) << "[\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &r = results[i];
+        file << "  {\"engine\": " << jsonString(r.engine)
+             << ", \"dataset\": " << jsonString(r.dataset)
+             << ", \"size\": [" << r.sizeX << ", " << r.sizeY << ", " << r.sizeZ << "]"
+             << ", \"iso_value\": " << r.isoValue
+             << ", \"threads\": " << r.threads
+             << ", \"warmup_runs\": " << r.warmupRuns
+             << ", \"runs\": " << r.runs
+             << ", \"triangles\": " << r.triangles
+             << ", \"min_ms\": " << r.stats.minMs
+             << ", \"median_ms\": " << r.stats.medianMs
+             << ", \"p95_ms\": " << r.stats.p95Ms
+             << ", \"mean_ms\": " << r.stats.meanMs
+             << ", \"max_ms\": " << r.stats.maxMs
+             << ", \"mcells_per_s\": " << r.cellsPerSecond() / 1e6
+             << ", \"samples_ms\": [";
+        for (size_t s = 0; s < r.samplesMs.size(); s++)
+        {
+            file << (s ? ", " : "") << r.samplesMs[s];
+        }
+        file << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "]\n";
+    return static_cast<bool>(file);
+}
+
+// Exporta los resultados como CSV (una fila por medición)
+bool writeResultsCsv(const std::vector<BenchmarkResult> &results, const std::string &filename)
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+
+    file << "engine,dataset,size_x,size_y,size_z,iso_value,threads,warmup_runs,runs,triangles,"
+            "min_ms,median_ms,p95_ms,mean_ms,max_ms,mcells_per_s\n";
+    file << std::setprecision(6);
+    for (const BenchmarkResult &r : results)
+    {
+        file << r.engine << "," << r.dataset << ","
+             << r.sizeX << "," << r.sizeY << "," << r.sizeZ << ","
+             << r.isoValue << "," << r.threads << ","
+             << r.warmupRuns << "," << r.runs << "," << r.triangles << ","
+             << r.stats.minMs << "," << r.stats.medianMs << "," << r.stats.p95Ms << ","
+             << r.stats.meanMs << "," << r.stats.maxMs << ","
+             << r.cellsPerSecond() / 1e6 << "\n";
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,66 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Configuración de una medición: ejecuciones de calentamiento (descartadas)
+// seguidas de 'runs' ejecuciones medidas
+struct BenchmarkConfig
+{
+    int warmupRuns;
+    int runs;
+
+    BenchmarkConfig(int warmup = 1, int measured = 5)
+        : warmupRuns(warmup), runs(measured) {}
+};
+
+// Estadísticas de las ejecuciones medidas (en milisegundos)
+struct BenchmarkStats
+{
+    double minMs;
+    double medianMs;
+    double p95Ms;
+    double meanMs;
+    double maxMs;
+
+    BenchmarkStats() : minMs(0), medianMs(0), p95Ms(0), meanMs(0), maxMs(0) {}
+};
+
+// Resultado de una medición, con todo lo necesario para reproducirla
+struct BenchmarkResult
+{
+    std::string engine;  // motor medido ("serial", "parallel-slabs", ...)
+    std::string dataset; // archivo o descripción del dataset sintético
+    int sizeX, sizeY, sizeZ;
+    float isoValue;
+    int threads;
+    int warmupRuns;
+    int runs;
+    long long triangles; // triángulos de la última ejecución
+    BenchmarkStats stats;
+    std::vector<double> samplesMs;
+
+    BenchmarkResult()
+        : sizeX(0), sizeY(0), sizeZ(0), isoValue(0), threads(1),
+          warmupRuns(0), runs(0), triangles(0) {}
+
+    // Celdas procesadas por segundo según la mediana
+    double cellsPerSecond() const;
+};
+
+// Calcula min/mediana/p95/media/max de una lista de tiempos
+BenchmarkStats computeStats(std::vector<double> samplesMs);
+
+// Ejecuta 'body' (que devuelve el número de triángulos generados) según
+// 'config' y rellena tiempos y estadísticas. El resto de campos descriptivos
+// del resultado los completa quien llama
+BenchmarkResult runBenchmark(const BenchmarkConfig &config,
+                             const std::function<long long()> &body);
+
+// Exportación en formatos legibles por máquina
+bool writeResultsJson(const std::vector<BenchmarkResult> &results, const std::string &filename);
+bool writeResultsCsv(const std::vector<BenchmarkResult> &results, const std::string &filename);
+
+#endif // BENCHMARK_H
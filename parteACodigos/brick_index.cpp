@@ -0,0 +1,149 @@
+#include "brick_index.h"
+#include <algorithm>
+
+BrickIndex::BrickIndex()
+    : brickSize(8), sizeX(0), sizeY(0), sizeZ(0)
+{
+}
+
+// Construye la jerarquía min/max
+void BrickIndex::build(const float *data, int sx, int sy, int sz, int size)
+{
+    levels.clear();
+    sizeX = sx;
+    sizeY = sy;
+    sizeZ = sz;
+    brickSize = std::max(1, size);
+
+    if (!data || sx < 2 || sy < 2 || sz < 2)
+    {
+        return;
+    }
+
+    // Nivel 0: un nodo por brick de celdas
+    Level base;
+    base.nx = (sx - 1 + brickSize - 1) / brickSize;
+    base.ny = (sy - 1 + brickSize - 1) / brickSize;
+    base.nz = (sz - 1 + brickSize - 1) / brickSize;
+    base.minValues.resize(static_cast<size_t>(base.nx) * base.ny * base.nz);
+    base.maxValues.resize(base.minValues.size());
+
+    const size_t strideZ = static_cast<size_t>(sx) * sy;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int bz = 0; bz < base.nz; bz++)
+    {
+        for (int by = 0; by < base.ny; by++)
+        {
+            for (int bx = 0; bx < base.nx; bx++)
+            {
+                // Las celdas [c0, c0 + brickSize) tocan los vóxeles [c0, c0 + brickSize]
+                int x0 = bx * brickSize, x1 = std::min(x0 + brickSize, sx - 1);
+                int y0 = by * brickSize, y1 = std::min(y0 + brickSize, sy - 1);
+                int z0 = bz * brickSize, z1 = std::min(z0 + brickSize, sz - 1);
+
+                float lo = data[z0 * strideZ + static_cast<size_t>(y0) * sx + x0];
+                float hi = lo;
+                for (int z = z0; z <= z1; z++)
+                {
+                    for (int y = y0; y <= y1; y++)
+                    {
+                        const float *row = data + z * strideZ + static_cast<size_t>(y) * sx;
+                        for (int x = x0; x <= x1; x++)
+                        {
+                            lo = std::min(lo, row[x]);
+                            hi = std::max(hi, row[x]);
+                        }
+                    }
+                }
+
+                size_t i = base.index(bx, by, bz);
+                base.minValues[i] = lo;
+                base.maxValues[i] = hi;
+            }
+        }
+    }
+    levels.push_back(std::move(base));
+
+    // Niveles superiores: reducción 2x2x2 hasta un único nodo
+    while (levels.back().nx > 1 || levels.back().ny > 1 || levels.back().nz > 1)
+    {
+        const Level &fine = levels.back();
+        Level coarse;
+        coarse.nx = (fine.nx + 1) / 2;
+        coarse.ny = (fine.ny + 1) / 2;
+        coarse.nz = (fine.nz + 1) / 2;
+        coarse.minValues.resize(static_cast<size_t>(coarse.nx) * coarse.ny * coarse.nz);
+        coarse.maxValues.resize(coarse.minValues.size());
+
+        for (int z = 0; z < coarse.nz; z++)
+        {
+            for (int y = 0; y < coarse.ny; y++)
+            {
+                for (int x = 0; x < coarse.nx; x++)
+                {
+                    size_t first = fine.index(2 * x, 2 * y, 2 * z);
+                    float lo = fine.minValues[first];
+                    float hi = fine.maxValues[first];
+                    for (int dz = 0; dz < 2 && 2 * z + dz < fine.nz; dz++)
+                    {
+                        for (int dy = 0; dy < 2 && 2 * y + dy < fine.ny; dy++)
+                        {
+                            for (int dx = 0; dx < 2 && 2 * x + dx < fine.nx; dx++)
+                            {
+                                size_t i = fine.index(2 * x + dx, 2 * y + dy, 2 * z + dz);
+                                lo = std::min(lo, fine.minValues[i]);
+                                hi = std::max(hi, fine.maxValues[i]);
+                            }
+                        }
+                    }
+                    size_t i = coarse.index(x, y, z);
+                    coarse.minValues[i] = lo;
+                    coarse.maxValues[i] = hi;
+                }
+            }
+        }
+        levels.push_back(std::move(coarse));
+    }
+}
+
+// Bricks del nivel 0 cuyo rango contiene el isovalor
+void BrickIndex::collectActiveBricks(float isoValue, std::vector<Brick> &bricks) const
+{
+    if (levels.empty())
+    {
+        return;
+    }
+    collect(static_cast<int>(levels.size()) - 1, 0, 0, 0, isoValue, bricks);
+}
+
+// Descenso recursivo por las ramas activas
+void BrickIndex::collect(int level, int x, int y, int z, float isoValue, std::vector<Brick> &bricks) const
+{
+    const Level &node = levels[level];
+    size_t i = node.index(x, y, z);
+    if (!spans(node.minValues[i], node.maxValues[i], isoValue))
+    {
+        return;
+    }
+
+    if (level == 0)
+    {
+        bricks.push_back(Brick{x, y, z});
+        return;
+    }
+
+    const Level &fine = levels[level - 1];
+    for (int dz = 0; dz < 2 && 2 * z + dz < fine.nz; dz++)
+    {
+        for (int dy = 0; dy < 2 && 2 * y + dy < fine.ny; dy++)
+        {
+            for (int dx = 0; dx < 2 && 2 * x + dx < fine.nx; dx++)
+            {
+                collect(level - 1, 2 * x + dx, 2 * y + dy, 2 * z + dz, isoValue, bricks);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef BRICK_INDEX_H
+#define BRICK_INDEX_H
+
+#include <cstddef>
+#include <vector>
+
+// Jerarquía de rangos min/max para saltar el espacio vacío.
+//
+// El nivel 0 divide las celdas (cubos) del volumen en bricks de
+// brickSize^3; cada brick guarda el mínimo y el máximo de los vóxeles que
+// tocan sus celdas (incluida la capa compartida con el brick siguiente). Cada
+// nivel superior agrupa 2x2x2 nodos del nivel anterior hasta llegar a un solo
+// nodo. Un brick cuyo rango no contiene el isovalor no puede generar
+// triángulos, así que el recorrido solo visita las ramas que lo contienen.
+//
+// Se construye una vez por volumen y sirve para cualquier isovalor.
+class BrickIndex
+{
+public:
+    // Coordenadas de un brick del nivel 0
+    struct Brick
+    {
+        int bx, by, bz;
+    };
+
+    BrickIndex();
+
+    // Construye la jerarquía para un campo con el orden de Volume
+    // (x más rápido). brickSize es el lado del brick en celdas
+    void build(const float *data, int sx, int sy, int sz, int brickSize = 8);
+
+    bool empty() const { return levels.empty(); }
+
+    // Lado del brick en celdas y número de bricks por eje del nivel 0
+    int getBrickSize() const { return brickSize; }
+    int bricksX() const { return levels.empty() ? 0 : levels[0].nx; }
+    int bricksY() const { return levels.empty() ? 0 : levels[0].ny; }
+    int bricksZ() const { return levels.empty() ? 0 : levels[0].nz; }
+    int numLevels() const { return static_cast<int>(levels.size()); }
+
+    // Dimensiones del campo indexado
+    int getSizeX() const { return sizeX; }
+    int getSizeY() const { return sizeY; }
+    int getSizeZ() const { return sizeZ; }
+
+    // Rango de valores de un brick del nivel 0
+    float brickMin(int bx, int by, int bz) const { return levels[0].minValues[levels[0].index(bx, by, bz)]; }
+    float brickMax(int bx, int by, int bz) const { return levels[0].maxValues[levels[0].index(bx, by, bz)]; }
+
+    // Añade a 'bricks' los bricks del nivel 0 cuyo rango contiene isoValue
+    // (en orden de recorrido de la jerarquía, no ordenados)
+    void collectActiveBricks(float isoValue, std::vector<Brick> &bricks) const;
+
+private:
+    struct Level
+    {
+        int nx, ny, nz;
+        std::vector<float> minValues;
+        std::vector<float> maxValues;
+
+        size_t index(int x, int y, int z) const
+        {
+            return (static_cast<size_t>(z) * ny + y) * nx + x;
+        }
+    };
+
+    // Un brick está activo si min < isoValue <= max (mismo criterio que la
+    // clasificación: una esquina cuenta como "dentro" si valor < isoValue)
+    static bool spans(float minValue, float maxValue, float isoValue)
+    {
+        return minValue < isoValue && isoValue <= maxValue;
+    }
+
+    void collect(int level, int x, int y, int z, float isoValue, std::vector<Brick> &bricks) const;
+
+    std::vector<Level> levels;
+    int brickSize;
+    int sizeX, sizeY, sizeZ;
+};
+
+#endif // BRICK_INDEX_H
@@ -0,0 +1,420 @@
+#include "cube_classifier.h"
+#include "src/scalar_types.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MC_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// Implementación escalar de referencia
+void classifyCubeRowScalar(const float *row00, const float *row10,
+                           const float *row01, const float *row11,
+                           int numCubes, float isoValue, unsigned char *cases)
+{
+    for (int x = 0; x < numCubes; x++)
+    {
+        int cubeIndex = 0;
+        cubeIndex |= (row00[x] < isoValue) << 0;
+        cubeIndex |= (row00[x + 1] < isoValue) << 1;
+        cubeIndex |= (row10[x + 1] < isoValue) << 2;
+        cubeIndex |= (row10[x] < isoValue) << 3;
+        cubeIndex |= (row01[x] < isoValue) << 4;
+        cubeIndex |= (row01[x + 1] < isoValue) << 5;
+        cubeIndex |= (row11[x + 1] < isoValue) << 6;
+        cubeIndex |= (row11[x] < isoValue) << 7;
+        cases[x] = static_cast<unsigned char>(cubeIndex);
+    }
+}
+
+#ifdef MC_HAVE_X86_KERNELS
+
+// Bits de las esquinas: la comparación devuelve todos los bits a 1 en los
+// carriles que cumplen la condición, así que basta con un AND con el bit
+#define MC_CORNER_BIT_SSE(row, offset, bit) \
+    _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps((row) + x + (offset)), iso)), _mm_set1_epi32(bit))
+
+// SSE2: 4 cubos por iteración
+__attribute__((target("sse2"))) static void classifyCubeRowSSE2(const float *row00, const float *row10,
+                                                                const float *row01, const float *row11,
+                                                                int numCubes, float isoValue,
+                                                                unsigned char *cases)
+{
+    const __m128 iso = _mm_set1_ps(isoValue);
+    int x = 0;
+    for (; x + 4 <= numCubes; x += 4)
+    {
+        __m128i c = MC_CORNER_BIT_SSE(row00, 0, 1);
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row00, 1, 2));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row10, 1, 4));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row10, 0, 8));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row01, 0, 16));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row01, 1, 32));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row11, 1, 64));
+        c = _mm_or_si128(c, MC_CORNER_BIT_SSE(row11, 0, 128));
+
+        // 4 x int32 -> 4 x uint8
+        __m128i packed = _mm_packs_epi32(c, c);
+        packed = _mm_packus_epi16(packed, packed);
+        int word = _mm_cvtsi128_si32(packed);
+        __builtin_memcpy(cases + x, &word, 4);
+    }
+
+    // Resto de la fila
+    classifyCubeRowScalar(row00 + x, row10 + x, row01 + x, row11 + x,
+                          numCubes - x, isoValue, cases + x);
+}
+
+#define MC_CORNER_BIT_AVX(row, offset, bit) \
+    _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(_mm256_loadu_ps((row) + x + (offset)), iso, _CMP_LT_OQ)), _mm256_set1_epi32(bit))
+
+// AVX2: 8 cubos por iteración
+__attribute__((target("avx2"))) static void classifyCubeRowAVX2(const float *row00, const float *row10,
+                                                                const float *row01, const float *row11,
+                                                                int numCubes, float isoValue,
+                                                                unsigned char *cases)
+{
+    const __m256 iso = _mm256_set1_ps(isoValue);
+    int x = 0;
+    for (; x + 8 <= numCubes; x += 8)
+    {
+        __m256i c = MC_CORNER_BIT_AVX(row00, 0, 1);
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row00, 1, 2));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row10, 1, 4));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row10, 0, 8));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row01, 0, 16));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row01, 1, 32));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row11, 1, 64));
+        c = _mm256_or_si256(c, MC_CORNER_BIT_AVX(row11, 0, 128));
+
+        // 8 x int32 -> 8 x uint8 conservando el orden
+        __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(c), _mm256_extracti128_si256(c, 1));
+        __m128i bytes = _mm_packus_epi16(words, words);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(cases + x), bytes);
+    }
+
+    // Resto de la fila
+    classifyCubeRowScalar(row00 + x, row10 + x, row01 + x, row11 + x,
+                          numCubes - x, isoValue, cases + x);
+}
+
+#undef MC_CORNER_BIT_SSE
+#undef MC_CORNER_BIT_AVX
+
+#endif // MC_HAVE_X86_KERNELS
+
+// Implementación escalar de referencia de la clasificación de aristas x
+int classifyEdgeRowScalar(const float *row, int numEdges, float isoValue,
+                          unsigned char *cases, int &xMin, int &xMax)
+{
+    xMin = numEdges;
+    xMax = 0;
+    int cuts = 0;
+    for (int x = 0; x < numEdges; x++)
+    {
+        int edgeCase = (row[x] < isoValue) | ((row[x + 1] < isoValue) << 1);
+        cases[x] = static_cast<unsigned char>(edgeCase);
+        if (edgeCase == 1 || edgeCase == 2)
+        {
+            xMin = std::min(xMin, x);
+            xMax = x + 1;
+            cuts++;
+        }
+    }
+    return cuts;
+}
+
+#ifdef MC_HAVE_X86_KERNELS
+
+// 16 comparaciones v < iso -> 16 bytes a 0x00 / 0xFF
+__attribute__((target("sse2"))) static inline __m128i belowMask16(const float *values, __m128 iso)
+{
+    __m128i low = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values), iso)),
+                                  _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + 4), iso)));
+    __m128i high = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + 8), iso)),
+                                   _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(values + 12), iso)));
+    return _mm_packs_epi16(low, high);
+}
+
+// SSE2: 16 aristas por iteración. Una arista está cortada cuando sus dos
+// vóxeles difieren, así que los cortes salen del XOR de las dos máscaras
+__attribute__((target("sse2"))) static int classifyEdgeRowSSE2(const float *row, int numEdges, float isoValue,
+                                                               unsigned char *cases, int &xMin, int &xMax)
+{
+    const __m128 iso = _mm_set1_ps(isoValue);
+    int cuts = 0;
+    int first = -1, last = -1;
+    int x = 0;
+    for (; x + 16 <= numEdges; x += 16)
+    {
+        __m128i left = belowMask16(row + x, iso);
+        __m128i right = belowMask16(row + x + 1, iso);
+        __m128i edgeCases = _mm_or_si128(_mm_and_si128(left, _mm_set1_epi8(1)),
+                                         _mm_and_si128(right, _mm_set1_epi8(2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cases + x), edgeCases);
+
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_xor_si128(left, right)));
+        if (mask)
+        {
+            cuts += __builtin_popcount(mask);
+            if (first < 0)
+            {
+                first = x + __builtin_ctz(mask);
+            }
+            last = x + 31 - __builtin_clz(mask);
+        }
+    }
+
+    // Resto de la fila
+    int restMin, restMax;
+    int restCuts = classifyEdgeRowScalar(row + x, numEdges - x, isoValue, cases + x, restMin, restMax);
+    if (restCuts > 0)
+    {
+        if (first < 0)
+        {
+            first = x + restMin;
+        }
+        last = x + restMax - 1;
+    }
+    cuts += restCuts;
+
+    xMin = first < 0 ? numEdges : first;
+    xMax = first < 0 ? 0 : last + 1;
+    return cuts;
+}
+
+#endif // MC_HAVE_X86_KERNELS
+
+// Selección de la implementación según la CPU (se evalúa una sola vez)
+static ClassifyRowFunc selectClassifyKernel(const char **name)
+{
+#ifdef MC_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        *name = "avx2";
+        return classifyCubeRowAVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        *name = "sse2";
+        return classifyCubeRowSSE2;
+    }
+#endif
+    *name = "scalar";
+    return classifyCubeRowScalar;
+}
+
+static const char *kernelName = "scalar";
+static const ClassifyRowFunc classifyKernel = selectClassifyKernel(&kernelName);
+
+// Clasifica una fila de cubos con la mejor implementación disponible
+void classifyCubeRow(const float *row00, const float *row10,
+                     const float *row01, const float *row11,
+                     int numCubes, float isoValue, unsigned char *cases)
+{
+    classifyKernel(row00, row10, row01, row11, numCubes, isoValue, cases);
+}
+
+// Clasificación por claves enteras para los tipos de almacenamiento reducido
+template <typename T>
+static void classifyCubeRowKeyed(const T *row00, const T *row10,
+                                 const T *row01, const T *row11,
+                                 int numCubes, int threshold, unsigned char *cases)
+{
+    typedef ScalarTraits<T> Traits;
+    for (int x = 0; x < numCubes; x++)
+    {
+        int cubeIndex = 0;
+        cubeIndex |= (Traits::key(row00[x]) < threshold) << 0;
+        cubeIndex |= (Traits::key(row00[x + 1]) < threshold) << 1;
+        cubeIndex |= (Traits::key(row10[x + 1]) < threshold) << 2;
+        cubeIndex |= (Traits::key(row10[x]) < threshold) << 3;
+        cubeIndex |= (Traits::key(row01[x]) < threshold) << 4;
+        cubeIndex |= (Traits::key(row01[x + 1]) < threshold) << 5;
+        cubeIndex |= (Traits::key(row11[x + 1]) < threshold) << 6;
+        cubeIndex |= (Traits::key(row11[x]) < threshold) << 7;
+        cases[x] = static_cast<unsigned char>(cubeIndex);
+    }
+}
+
+// Umbral fuera del rango de claves: todos los cubos tienen el mismo índice.
+// Devuelve true si ya se ha escrito la fila
+static bool classifyUniformRow(int numCubes, int threshold, int numKeys, unsigned char *cases)
+{
+    if (threshold <= 0 || threshold >= numKeys)
+    {
+        __builtin_memset(cases, threshold <= 0 ? 0 : 255, numCubes);
+        return true;
+    }
+    return false;
+}
+
+#ifdef MC_HAVE_X86_KERNELS
+
+// SSE2 para 8 bits: v < t  <=>  max(v, t - 1) == t - 1 (16 cubos por iteración)
+#define MC_CORNER_BIT_U8(row, offset, bit)                                                        \
+    _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(_mm_loadu_si128(                                      \
+                                                  reinterpret_cast<const __m128i *>((row) + x + (offset))), \
+                                              limit),                                               \
+                                 limit),                                                            \
+                  _mm_set1_epi8(static_cast<char>(bit)))
+
+__attribute__((target("sse2"))) static void classifyCubeRowU8SSE2(const uint8_t *row00, const uint8_t *row10,
+                                                                  const uint8_t *row01, const uint8_t *row11,
+                                                                  int numCubes, int threshold,
+                                                                  unsigned char *cases)
+{
+    if (classifyUniformRow(numCubes, threshold, 256, cases))
+    {
+        return;
+    }
+
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold - 1));
+    int x = 0;
+    for (; x + 16 <= numCubes; x += 16)
+    {
+        __m128i c = MC_CORNER_BIT_U8(row00, 0, 1);
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row00, 1, 2));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row10, 1, 4));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row10, 0, 8));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row01, 0, 16));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row01, 1, 32));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row11, 1, 64));
+        c = _mm_or_si128(c, MC_CORNER_BIT_U8(row11, 0, 128));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(cases + x), c);
+    }
+
+    // Resto de la fila
+    classifyCubeRowKeyed(row00 + x, row10 + x, row01 + x, row11 + x,
+                         numCubes - x, threshold, cases + x);
+}
+
+// SSE2 para 16 bits (8 cubos por iteración). Solo hay comparación con signo,
+// así que claves y umbral se desplazan restando 0x8000 (XOR del bit alto).
+// Para half la clave con signo es bits ^ ((bits >> 15) & 0x7FFF)
+__attribute__((target("sse2"))) static inline __m128i loadKey16(const uint16_t *p)
+{
+    return _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), _mm_set1_epi16(-0x8000));
+}
+
+__attribute__((target("sse2"))) static inline __m128i loadKey16(const Half *p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    return _mm_xor_si128(v, _mm_and_si128(_mm_srai_epi16(v, 15), _mm_set1_epi16(0x7FFF)));
+}
+
+#define MC_CORNER_BIT_16(row, offset, bit) \
+    _mm_and_si128(_mm_cmplt_epi16(loadKey16((row) + x + (offset)), limit), _mm_set1_epi16(bit))
+
+template <typename T>
+__attribute__((target("sse2"))) static void classifyCubeRow16SSE2(const T *row00, const T *row10,
+                                                                  const T *row01, const T *row11,
+                                                                  int numCubes, int threshold,
+                                                                  unsigned char *cases)
+{
+    if (classifyUniformRow(numCubes, threshold, 65536, cases))
+    {
+        return;
+    }
+
+    const __m128i limit = _mm_set1_epi16(static_cast<short>(threshold - 0x8000));
+    int x = 0;
+    for (; x + 8 <= numCubes; x += 8)
+    {
+        __m128i c = MC_CORNER_BIT_16(row00, 0, 1);
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row00, 1, 2));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row10, 1, 4));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row10, 0, 8));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row01, 0, 16));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row01, 1, 32));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row11, 1, 64));
+        c = _mm_or_si128(c, MC_CORNER_BIT_16(row11, 0, 128));
+
+        // 8 x int16 -> 8 x uint8
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(cases + x), _mm_packus_epi16(c, c));
+    }
+
+    // Resto de la fila
+    classifyCubeRowKeyed(row00 + x, row10 + x, row01 + x, row11 + x,
+                         numCubes - x, threshold, cases + x);
+}
+
+#undef MC_CORNER_BIT_U8
+#undef MC_CORNER_BIT_16
+
+#endif // MC_HAVE_X86_KERNELS
+
+// Los tipos reducidos y la clasificación de aristas usan SSE2 si la CPU lo
+// tiene y si no el bucle escalar
+static bool cpuHasSSE2()
+{
+#ifdef MC_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#else
+    return false;
+#endif
+}
+
+static const bool hasSSE2 = cpuHasSSE2();
+
+void classifyCubeRow(const uint8_t *row00, const uint8_t *row10,
+                     const uint8_t *row01, const uint8_t *row11,
+                     int numCubes, int threshold, unsigned char *cases)
+{
+#ifdef MC_HAVE_X86_KERNELS
+    if (hasSSE2)
+    {
+        classifyCubeRowU8SSE2(row00, row10, row01, row11, numCubes, threshold, cases);
+        return;
+    }
+#endif
+    classifyCubeRowKeyed(row00, row10, row01, row11, numCubes, threshold, cases);
+}
+
+void classifyCubeRow(const uint16_t *row00, const uint16_t *row10,
+                     const uint16_t *row01, const uint16_t *row11,
+                     int numCubes, int threshold, unsigned char *cases)
+{
+#ifdef MC_HAVE_X86_KERNELS
+    if (hasSSE2)
+    {
+        classifyCubeRow16SSE2(row00, row10, row01, row11, numCubes, threshold, cases);
+        return;
+    }
+#endif
+    classifyCubeRowKeyed(row00, row10, row01, row11, numCubes, threshold, cases);
+}
+
+void classifyCubeRow(const Half *row00, const Half *row10,
+                     const Half *row01, const Half *row11,
+                     int numCubes, int threshold, unsigned char *cases)
+{
+#ifdef MC_HAVE_X86_KERNELS
+    if (hasSSE2)
+    {
+        classifyCubeRow16SSE2(row00, row10, row01, row11, numCubes, threshold, cases);
+        return;
+    }
+#endif
+    classifyCubeRowKeyed(row00, row10, row01, row11, numCubes, threshold, cases);
+}
+
+int classifyEdgeRow(const float *row, int numEdges, float isoValue,
+                    unsigned char *cases, int &xMin, int &xMax)
+{
+#ifdef MC_HAVE_X86_KERNELS
+    if (hasSSE2)
+    {
+        return classifyEdgeRowSSE2(row, numEdges, isoValue, cases, xMin, xMax);
+    }
+#endif
+    return classifyEdgeRowScalar(row, numEdges, isoValue, cases, xMin, xMax);
+}
+
+// Nombre de la implementación seleccionada
+const char *classifyKernelName()
+{
+    return kernelName;
+}
@@ -0,0 +1,66 @@
+#ifndef CUBE_CLASSIFIER_H
+#define CUBE_CLASSIFIER_H
+
+#include <cstdint>
+
+struct Half;
+
+// Clasificación vectorizada de filas completas de cubos.
+//
+// Para la fila de cubos (y, z) se reciben las cuatro filas de vóxeles que la
+// delimitan y se escribe el índice de configuración (0-255) de cada cubo:
+//   row00 = vóxeles (*, y,     z)      -> esquinas 0 (x) y 1 (x+1)
+//   row10 = vóxeles (*, y + 1, z)      -> esquinas 3 (x) y 2 (x+1)
+//   row01 = vóxeles (*, y,     z + 1)  -> esquinas 4 (x) y 5 (x+1)
+//   row11 = vóxeles (*, y + 1, z + 1)  -> esquinas 7 (x) y 6 (x+1)
+// Cada fila debe contener numCubes + 1 valores. El bit i del índice vale 1
+// cuando el valor de la esquina i es menor que isoValue.
+//
+// La implementación (AVX2, SSE2 o escalar) se elige en tiempo de ejecución
+// según la CPU; todas producen exactamente el mismo resultado.
+
+typedef void (*ClassifyRowFunc)(const float *row00, const float *row10,
+                                const float *row01, const float *row11,
+                                int numCubes, float isoValue,
+                                unsigned char *cases);
+
+// Clasifica una fila de cubos con la mejor implementación disponible
+void classifyCubeRow(const float *row00, const float *row10,
+                     const float *row01, const float *row11,
+                     int numCubes, float isoValue, unsigned char *cases);
+
+// Implementación escalar de referencia
+void classifyCubeRowScalar(const float *row00, const float *row10,
+                           const float *row01, const float *row11,
+                           int numCubes, float isoValue, unsigned char *cases);
+
+// Versiones para almacenamiento reducido (ver src/scalar_types.h): cada
+// esquina se compara por su clave entera, key(v) < threshold, donde
+// threshold es el isovalor ya traducido al dominio almacenado. Son bucles
+// escalares sin saltos que el compilador vectoriza
+void classifyCubeRow(const uint8_t *row00, const uint8_t *row10,
+                     const uint8_t *row01, const uint8_t *row11,
+                     int numCubes, int threshold, unsigned char *cases);
+void classifyCubeRow(const uint16_t *row00, const uint16_t *row10,
+                     const uint16_t *row01, const uint16_t *row11,
+                     int numCubes, int threshold, unsigned char *cases);
+void classifyCubeRow(const Half *row00, const Half *row10,
+                     const Half *row01, const Half *row11,
+                     int numCubes, int threshold, unsigned char *cases);
+
+// Clasificación de las numEdges aristas x de una fila de vóxeles (la fila
+// tiene numEdges + 1 valores): cases[x] = bit 0 si row[x] < isoValue y bit 1
+// si row[x + 1] < isoValue. Devuelve el número de aristas cortadas (casos 1
+// y 2) y en [xMin, xMax) el tramo que las contiene (numEdges y 0 si no hay
+// ninguna). Usado por el motor Flying Edges
+int classifyEdgeRow(const float *row, int numEdges, float isoValue,
+                    unsigned char *cases, int &xMin, int &xMax);
+
+// Implementación escalar de referencia
+int classifyEdgeRowScalar(const float *row, int numEdges, float isoValue,
+                          unsigned char *cases, int &xMin, int &xMax);
+
+// Nombre de la implementación seleccionada ("avx2", "sse2" o "scalar")
+const char *classifyKernelName();
+
+#endif // CUBE_CLASSIFIER_H
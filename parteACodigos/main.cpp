@@ -5,62 +5,124 @@
 #include <chrono>
 #include <cmath>
 #include <iomanip>
+#include <memory>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Incluir las implementaciones
-#include "marching_cube_serial.cpp"
+#include "marching_cube_serial.h"
+#include "marching_cube_parallel.h"
+#include "marching_cube_streaming.h"
+#include "marching_cube_implicit.h"
+#include "marching_cube_bricked.h"
+#include "marching_cube_flying_edges.h"
+#include "brick_index.h"
+#include "batch_pipeline.h"
+#include "mesh_sink.h"
+#include "src/mapped_volume.h"
+#include "benchmark.h"
+#include "perf_counters.h"
+#include "src/metrics.h"
+#include "src/field_samplers.h"
 
-struct PerformanceMetrics
+// Fila de los datos de escalabilidad (medianas medidas, no estimadas)
+struct ScalingPoint
 {
-    double executionTime;
-    double throughput;
-    int triangleCount;
+    int gridSize;
+    int threads;
+    double serialMs;
+    double parallelMs;
     double flops;
 };
 
 class PerformanceAnalyzer
 {
 private:
-    std::vector<PerformanceMetrics> serialMetrics;
-    std::vector<PerformanceMetrics> parallelMetrics;
+    BenchmarkConfig config;
+    std::vector<BenchmarkResult> results;
+    std::vector<ScalingPoint> strongScaling;
+    std::vector<ScalingPoint> weakScaling;
+
+    // Jerarquía min/max del campo analizado (vacía hasta buildBrickIndex)
+    BrickIndex brickIndex;
+
+    // Completa los campos descriptivos de una medición y la guarda
+    BenchmarkResult record(BenchmarkResult result, const std::string &engine,
+                           const std::string &dataset, int gridSize,
+                           float isoValue, int threads)
+    {
+        result.engine = engine;
+        result.dataset = dataset;
+        result.sizeX = result.sizeY = result.sizeZ = gridSize;
+        result.isoValue = isoValue;
+        result.threads = threads;
+        results.push_back(result);
+        return result;
+    }
 
 public:
-    // Cargar datos de volumen desde archivo binario
-    std::vector<float> loadVolumeData(const std::string &filename, int &gridSize)
+    explicit PerformanceAnalyzer(const BenchmarkConfig &cfg = BenchmarkConfig()) : config(cfg) {}
+
+    const std::vector<BenchmarkResult> &getResults() const { return results; }
+
+    // Proyectar en memoria un archivo .bin (cabecera nx, ny, nz + floats)
+    // sin copiarlo; el analizador requiere una malla cúbica
+    void loadVolumeData(const std::string &filename, MappedVolume &volume, int &gridSize)
     {
-        std::ifstream file(filename, std::ios::binary);
-        if (!file.is_open())
+        if (!volume.open(filename))
         {
             throw std::runtime_error("Cannot open file: " + filename);
         }
 
-        // Leer tamaño (asumiendo que está al inicio del archivo)
-        file.read(reinterpret_cast<char *>(&gridSize), sizeof(int));
+        if (volume.nx() != volume.ny() || volume.nx() != volume.nz())
+        {
+            throw std::runtime_error("Expected a cubic grid in " + filename);
+        }
+        gridSize = volume.nx();
+    }
 
-        // Leer datos
-        int totalSize = gridSize * gridSize * gridSize;
-        std::vector<float> data(totalSize);
-        file.read(reinterpret_cast<char *>(data.data()), totalSize * sizeof(float));
+    // Construye el índice de bricks del campo analizado. Se hace una vez por
+    // volumen: sirve para cualquier isovalor y no entra en las mediciones
+    void buildBrickIndex(const float *volumeData, int gridSize)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        brickIndex.build(volumeData, gridSize, gridSize, gridSize);
+        auto end = std::chrono::high_resolution_clock::now();
 
-        return data;
+        std::cout << "Brick index: " << brickIndex.bricksX() << "x" << brickIndex.bricksY() << "x"
+                  << brickIndex.bricksZ() << " bricks of " << brickIndex.getBrickSize() << "³ cells, built in "
+                  << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
     }
 
     // Generar datos sintéticos (esfera)
     std::vector<float> generateSphereData(int gridSize, float radius)
     {
-        std::vector<float> data(gridSize * gridSize * gridSize);
+        std::vector<float> data(static_cast<size_t>(gridSize) * gridSize * gridSize);
         float center = gridSize / 2.0f;
 
+        // Planos z en paralelo, bucle en x vectorizable
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
         for (int z = 0; z < gridSize; z++)
         {
+            float dz = z - center;
+            float dz2 = dz * dz;
             for (int y = 0; y < gridSize; y++)
             {
+                float dy = y - center;
+                float dy2 = dy * dy;
+                float *row = &data[(static_cast<size_t>(z) * gridSize + y) * gridSize];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
                 for (int x = 0; x < gridSize; x++)
                 {
                     float dx = x - center;
-                    float dy = y - center;
-                    float dz = z - center;
-                    float distance = sqrt(dx * dx + dy * dy + dz * dz);
-                    data[z * gridSize * gridSize + y * gridSize + x] = radius - distance;
+                    row[x] = radius - std::sqrt(dx * dx + dy2 + dz2);
                 }
             }
         }
@@ -68,92 +130,181 @@ public:
     }
 
     // Calcular FLOPs para Marching Cubes
-    double calculateFLOPs(int gridSize, int triangleCount)
+    double calculateFLOPs(int gridSize, long long triangleCount)
     {
-        int numCubes = (gridSize - 1) * (gridSize - 1) * (gridSize - 1);
+        double numCubes = static_cast<double>(gridSize - 1) * (gridSize - 1) * (gridSize - 1);
 
         // FLOPs por cubo:
         // - 8 comparaciones para índice de configuración
-        // - ~12 interpolaciones (3 muls + 3 adds por interpolación)
         // - Acceso a tabla (consideramos 0 FLOPs)
-        double flopsPerCube = 8 + 12 * 6; // promedio de interpolaciones
-
-        return numCubes * flopsPerCube;
+        // FLOPs por triángulo:
+        // - 3 interpolaciones (1 div + 1 sub + 3 muls + 6 adds por interpolación)
+        return numCubes * 8 + static_cast<double>(triangleCount) * 3 * 11;
     }
 
-    // Ejecutar prueba serial
-    PerformanceMetrics runSerialTest(float *volumeData, int gridSize, float isoValue)
+    // Medir el motor serial (calentamiento + ejecuciones repetidas); con
+    // 'bricks' se saltan los bricks que no contienen el isovalor
+    BenchmarkResult runSerialTest(const float *volumeData, int gridSize, float isoValue,
+                                  const std::string &dataset, const BrickIndex *bricks = nullptr)
     {
-        PerformanceMetrics metrics;
-
-        auto start = std::chrono::high_resolution_clock::now();
+        MarchingCubesSerial mc;
+        mc.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        mc.setIsoValue(isoValue);
+        mc.setBrickIndex(bricks);
+        std::vector<Triangle> triangles;
 
-        // MarchingCubesSerial mc(volumeData, gridSize, isoValue);
-        // auto triangles = mc.extractIsosurface();
-
-        auto end = std::chrono::high_resolution_clock::now();
+        BenchmarkResult result = runBenchmark(config, [&]() -> long long {
+            return mc.generateIsosurface(triangles);
+        });
+        return record(result, bricks ? "serial+bricks" : "serial", dataset, gridSize, isoValue, 1);
+    }
 
-        metrics.executionTime = std::chrono::duration<double, std::milli>(end - start).count();
-        metrics.triangleCount = 0; // triangles.size();
-        metrics.throughput = (gridSize * gridSize * gridSize) / (metrics.executionTime * 1e3);
-        metrics.flops = calculateFLOPs(gridSize, metrics.triangleCount);
+    // Medir el motor paralelo con 'numThreads' hilos; incluye la fusión de
+    // los buffers de cada hilo
+    BenchmarkResult runParallelTest(const float *volumeData, int gridSize, float isoValue,
+                                    int numThreads, ParallelMode mode,
+                                    const std::string &dataset, const BrickIndex *bricks = nullptr)
+    {
+        MarchingCubesParallel mc;
+        mc.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        mc.setIsoValue(isoValue);
+        mc.setNumThreads(numThreads);
+        mc.setMode(mode);
+        mc.setBrickIndex(bricks);
+        std::vector<Triangle> triangles;
 
-        return metrics;
+        BenchmarkResult result = runBenchmark(config, [&]() -> long long {
+            return mc.generateIsosurface(triangles);
+        });
+        std::string engine = parallelModeName(mode);
+        return record(result, bricks ? engine + "+bricks" : engine, dataset, gridSize, isoValue, numThreads);
     }
 
-    // Ejecutar prueba paralela
-    PerformanceMetrics runParallelTest(float *volumeData, int gridSize, float isoValue, int blockSize)
+    // Medir el motor Flying Edges con 'numThreads' hilos
+    BenchmarkResult runFlyingEdgesTest(const float *volumeData, int gridSize, float isoValue,
+                                       int numThreads, const std::string &dataset)
     {
-        PerformanceMetrics metrics;
+        MarchingCubesFlyingEdges mc;
+        mc.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        mc.setIsoValue(isoValue);
+        mc.setNumThreads(numThreads);
+        std::vector<Triangle> triangles;
 
-        // Incluir tiempo de transferencia de datos
-        auto start = std::chrono::high_resolution_clock::now();
+        BenchmarkResult result = runBenchmark(config, [&]() -> long long {
+            return mc.generateIsosurface(triangles);
+        });
+        return record(result, "flying-edges", dataset, gridSize, isoValue, numThreads);
+    }
 
-        // MarchingCubesCUDAOptimized mc(volumeData, gridSize, isoValue);
-        // auto triangles = mc.extractIsosurface();
+    // Medir el motor serial sobre vóxeles almacenados como T
+    template <typename T>
+    BenchmarkResult runTypedTest(const T *volumeData, float scale, float offset, int gridSize,
+                                 float isoValue, const std::string &dataset)
+    {
+        MarchingCubesSerialT<T> mc;
+        mc.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        mc.setValueMapping(scale, offset);
+        mc.setIsoValue(isoValue);
+        std::vector<Triangle> triangles;
 
-        auto end = std::chrono::high_resolution_clock::now();
+        BenchmarkResult result = runBenchmark(config, [&]() -> long long {
+            return mc.generateIsosurface(triangles);
+        });
+        return record(result, std::string("serial-") + ScalarTraits<T>::name(), dataset, gridSize, isoValue, 1);
+    }
 
-        metrics.executionTime = std::chrono::duration<double, std::milli>(end - start).count();
-        metrics.triangleCount = 0; // triangles.size();
-        metrics.throughput = (gridSize * gridSize * gridSize) / (metrics.executionTime * 1e3);
-        metrics.flops = calculateFLOPs(gridSize, metrics.triangleCount);
+    // Número máximo de hilos disponibles
+    int maxThreads() const
+    {
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
 
-        return metrics;
+    // Lista de hilos a probar: potencias de 2 hasta el máximo disponible
+    std::vector<int> threadCounts() const
+    {
+        std::vector<int> counts;
+        for (int t = 1; t < maxThreads(); t *= 2)
+        {
+            counts.push_back(t);
+        }
+        counts.push_back(maxThreads());
+        return counts;
     }
 
     // Análisis de escalabilidad fuerte
-    void strongScalingAnalysis(float *volumeData, int gridSize, float isoValue)
+    void strongScalingAnalysis(const float *volumeData, int gridSize, float isoValue,
+                               const std::string &dataset)
     {
         std::cout << "\n=== Strong Scaling Analysis ===\n";
-        std::cout << "Grid Size: " << gridSize << "³\n\n";
-
-        std::vector<int> blockSizes = {4, 8, 16, 32};
-        std::vector<double> speedups;
+        std::cout << "Dataset: " << dataset << ", grid size: " << gridSize << "³\n";
+        std::cout << "Warmup runs: " << config.warmupRuns << ", measured runs: " << config.runs << "\n\n";
 
         // Baseline serial
-        auto serialMetric = runSerialTest(volumeData, gridSize, isoValue);
-        std::cout << "Serial Time: " << serialMetric.executionTime << " ms\n\n";
+        BenchmarkResult serialResult = runSerialTest(volumeData, gridSize, isoValue, dataset);
+        double serialMs = serialResult.stats.medianMs;
+        long long serialTriangles = serialResult.triangles;
+        std::cout << "Serial median: " << serialMs << " ms (p95 " << serialResult.stats.p95Ms
+                  << " ms, min " << serialResult.stats.minMs << " ms)\n\n";
 
-        std::cout << std::setw(12) << "Block Size"
-                  << std::setw(15) << "Time (ms)"
-                  << std::setw(15) << "Speedup"
-                  << std::setw(15) << "Efficiency\n";
-        std::cout << std::string(60, '-') << "\n";
+        std::cout << std::setw(10) << "Threads"
+                  << std::setw(24) << "Engine"
+                  << std::setw(14) << "Median (ms)"
+                  << std::setw(12) << "p95 (ms)"
+                  << std::setw(12) << "Speedup"
+                  << std::setw(12) << "Efficiency" << "\n";
+        std::cout << std::string(84, '-') << "\n";
 
-        for (int blockSize : blockSizes)
+        // Fila de la tabla para una medición
+        auto report = [&](const BenchmarkResult &r) {
+            double speedup = serialMs / r.stats.medianMs;
+
+            std::cout << std::setw(10) << r.threads
+                      << std::setw(24) << r.engine
+                      << std::setw(14) << std::fixed << std::setprecision(2) << r.stats.medianMs
+                      << std::setw(12) << r.stats.p95Ms
+                      << std::setw(12) << speedup
+                      << std::setw(12) << speedup / r.threads << "\n";
+
+            if (r.triangles != serialTriangles)
+            {
+                std::cerr << "Warning: " << r.engine << " generated " << r.triangles
+                          << " triangles, serial generated " << serialTriangles << "\n";
+            }
+        };
+
+        // Salto de espacio vacío con el índice del campo (si se construyó)
+        const BrickIndex *bricks = brickIndex.empty() ? nullptr : &brickIndex;
+        if (bricks)
+        {
+            report(runSerialTest(volumeData, gridSize, isoValue, dataset, bricks));
+        }
+
+        for (int threads : threadCounts())
         {
-            auto metric = runParallelTest(volumeData, gridSize, isoValue, blockSize);
-            double speedup = serialMetric.executionTime / metric.executionTime;
-            double efficiency = speedup / (blockSize * blockSize * blockSize);
+            for (ParallelMode mode : {ParallelMode::SLAB_BUFFERS, ParallelMode::COUNT_THEN_EMIT,
+                                      ParallelMode::BRICK_TASKS})
+            {
+                BenchmarkResult r = runParallelTest(volumeData, gridSize, isoValue, threads, mode, dataset);
+                report(r);
+                if (mode == ParallelMode::SLAB_BUFFERS)
+                {
+                    strongScaling.push_back({gridSize, threads, serialMs, r.stats.medianMs,
+                                             calculateFLOPs(gridSize, r.triangles)});
+                }
+            }
 
-            std::cout << std::setw(12) << blockSize
-                      << std::setw(15) << std::fixed << std::setprecision(2)
-                      << metric.executionTime
-                      << std::setw(15) << speedup
-                      << std::setw(15) << efficiency << "\n";
+            if (bricks)
+            {
+                report(runParallelTest(volumeData, gridSize, isoValue, threads,
+                                       ParallelMode::SLAB_BUFFERS, dataset, bricks));
+            }
 
-            speedups.push_back(speedup);
+            // Motor alternativo: Flying Edges
+            report(runFlyingEdgesTest(volumeData, gridSize, isoValue, threads, dataset));
         }
     }
 
@@ -163,95 +314,263 @@ public:
         std::cout << "\n=== Weak Scaling Analysis ===\n";
         std::cout << "Work per thread: constant\n\n";
 
-        std::vector<int> gridSizes = {64, 128, 256, 512};
-        std::vector<int> blockSizes = {4, 8, 16, 32};
+        // Volumen por hilo constante: gridSize = baseSize * cbrt(threads)
+        const int baseSize = 128;
 
         std::cout << std::setw(12) << "Grid Size"
-                  << std::setw(15) << "Block Size"
-                  << std::setw(15) << "Time (ms)"
-                  << std::setw(20) << "Throughput (Mvox/s)\n";
-        std::cout << std::string(65, '-') << "\n";
+                  << std::setw(15) << "Threads"
+                  << std::setw(15) << "Median (ms)"
+                  << std::setw(15) << "p95 (ms)"
+                  << std::setw(22) << "Throughput (Mcell/s)" << "\n";
+        std::cout << std::string(79, '-') << "\n";
 
-        for (int i = 0; i < gridSizes.size(); i++)
+        for (int threads : threadCounts())
         {
-            auto data = generateSphereData(gridSizes[i], gridSizes[i] * 0.4f);
-            auto metric = runParallelTest(data.data(), gridSizes[i], isoValue, blockSizes[i]);
-
-            std::cout << std::setw(12) << gridSizes[i]
-                      << std::setw(15) << blockSizes[i]
-                      << std::setw(15) << std::fixed << std::setprecision(2)
-                      << metric.executionTime
-                      << std::setw(20) << metric.throughput / 1e6 << "\n";
+            int gridSize = static_cast<int>(std::lround(baseSize * std::cbrt(static_cast<double>(threads))));
+            auto data = generateSphereData(gridSize, gridSize * 0.4f);
+            std::string dataset = "sphere-" + std::to_string(gridSize);
+
+            double serialMs = runSerialTest(data.data(), gridSize, isoValue, dataset).stats.medianMs;
+            BenchmarkResult r = runParallelTest(data.data(), gridSize, isoValue, threads,
+                                                ParallelMode::SLAB_BUFFERS, dataset);
+
+            std::cout << std::setw(12) << gridSize
+                      << std::setw(15) << threads
+                      << std::setw(15) << std::fixed << std::setprecision(2) << r.stats.medianMs
+                      << std::setw(15) << r.stats.p95Ms
+                      << std::setw(22) << r.cellsPerSecond() / 1e6 << "\n";
+
+            weakScaling.push_back({gridSize, threads, serialMs, r.stats.medianMs,
+                                   calculateFLOPs(gridSize, r.triangles)});
         }
     }
 
     // Análisis de rendimiento detallado
-    void detailedPerformanceAnalysis(float *volumeData, int gridSize, float isoValue)
+    void detailedPerformanceAnalysis(const float *volumeData, int gridSize, float isoValue,
+                                     const std::string &dataset)
     {
         std::cout << "\n=== Detailed Performance Analysis ===\n";
 
-        // Ejecutar múltiples iteraciones para promediar
-        const int iterations = 10;
-        double totalSerialTime = 0;
-        double totalParallelTime = 0;
-        double totalFLOPs = 0;
-
-        for (int i = 0; i < iterations; i++)
-        {
-            auto serialMetric = runSerialTest(volumeData, gridSize, isoValue);
-            auto parallelMetric = runParallelTest(volumeData, gridSize, isoValue, 8);
-
-            totalSerialTime += serialMetric.executionTime;
-            totalParallelTime += parallelMetric.executionTime;
-            totalFLOPs = parallelMetric.flops; // Mismo para ambos
-        }
-
-        double avgSerialTime = totalSerialTime / iterations;
-        double avgParallelTime = totalParallelTime / iterations;
+        BenchmarkResult serial = runSerialTest(volumeData, gridSize, isoValue, dataset);
+        double serialMs = serial.stats.medianMs;
+        BenchmarkResult parallel = runParallelTest(volumeData, gridSize, isoValue, maxThreads(),
+                                                   ParallelMode::SLAB_BUFFERS, dataset);
+        double parallelMs = parallel.stats.medianMs;
+        double totalFLOPs = calculateFLOPs(gridSize, parallel.triangles);
 
-        std::cout << "\nAverage Execution Times (over " << iterations << " runs):\n";
-        std::cout << "  Serial:   " << avgSerialTime << " ms\n";
-        std::cout << "  Parallel: " << avgParallelTime << " ms\n";
-        std::cout << "  Speedup:  " << avgSerialTime / avgParallelTime << "x\n";
+        std::cout << "\nMedian Execution Times (over " << config.runs << " runs, "
+                  << parallel.threads << " threads):\n";
+        std::cout << "  Serial:   " << serialMs << " ms\n";
+        std::cout << "  Parallel: " << parallelMs << " ms\n";
+        std::cout << "  Speedup:  " << serialMs / parallelMs << "x\n";
+        std::cout << "  Triangles: " << parallel.triangles << "\n";
 
         std::cout << "\nCompute Performance:\n";
         std::cout << "  Total FLOPs:     " << totalFLOPs << "\n";
-        std::cout << "  Serial GFLOPS:   " << (totalFLOPs / avgSerialTime) / 1e6 << "\n";
-        std::cout << "  Parallel GFLOPS: " << (totalFLOPs / avgParallelTime) / 1e6 << "\n";
+        std::cout << "  Serial GFLOPS:   " << (totalFLOPs / serialMs) / 1e6 << "\n";
+        std::cout << "  Parallel GFLOPS: " << (totalFLOPs / parallelMs) / 1e6 << "\n";
 
         // Análisis de ancho de banda
-        double dataSize = gridSize * gridSize * gridSize * sizeof(float);
-        double bandwidth = dataSize / (avgParallelTime * 1e6); // GB/s
+        double dataSize = static_cast<double>(gridSize) * gridSize * gridSize * sizeof(float);
+        double bandwidth = dataSize / (parallelMs * 1e6); // GB/s
 
         std::cout << "\nMemory Bandwidth:\n";
         std::cout << "  Data size:         " << dataSize / 1e9 << " GB\n";
         std::cout << "  Effective B/W:     " << bandwidth << " GB/s\n";
+
+        hardwareCounterAnalysis(volumeData, gridSize, isoValue);
     }
 
-    // Generar gráficas (datos para gnuplot)
+    // Contadores de hardware por fase de la extracción (ciclos, instrucciones,
+    // fallos de LLC y de predicción de saltos), acumulados sobre config.runs
+    // ejecuciones instrumentadas
+    void hardwareCounterAnalysis(const float *volumeData, int gridSize, float isoValue)
+    {
+        std::cout << "\n=== Per-Phase Hardware Counters ===\n";
+
+        PhaseProfiler profiler;
+        if (!profiler.open())
+        {
+            std::cout << "Hardware counters unavailable (perf_event_open failed, check "
+                         "/proc/sys/kernel/perf_event_paranoid); reporting times only\n";
+        }
+
+        // Clasificación, interpolación y emisión en el motor serial instrumentado
+        MarchingCubesSerial serial;
+        serial.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        serial.setIsoValue(isoValue);
+        std::vector<Triangle> triangles;
+        for (int i = 0; i < config.warmupRuns; i++)
+        {
+            serial.generateIsosurfaceProfiled(triangles, profiler);
+        }
+        profiler.reset();
+        for (int i = 0; i < config.runs; i++)
+        {
+            serial.generateIsosurfaceProfiled(triangles, profiler);
+        }
+
+        // Fusión de los buffers de los hilos en el motor paralelo
+        MarchingCubesParallel parallel;
+        parallel.setScalarField(volumeData, gridSize, gridSize, gridSize);
+        parallel.setIsoValue(isoValue);
+        parallel.setNumThreads(maxThreads());
+        parallel.setMode(ParallelMode::SLAB_BUFFERS);
+        parallel.generateIsosurface(triangles);
+        parallel.setProfiler(&profiler);
+        for (int i = 0; i < config.runs; i++)
+        {
+            parallel.generateIsosurface(triangles);
+        }
+
+        // Valor por ejecución, o "n/a" si el contador no está disponible
+        auto cell = [&](bool available, double value, int precision) {
+            std::ostringstream text;
+            if (available)
+            {
+                text << std::fixed << std::setprecision(precision) << value;
+            }
+            else
+            {
+                text << "n/a";
+            }
+            return text.str();
+        };
+        auto counter = [&](PerfCounterGroup::Counter c, double value) {
+            return cell(profiler.isAvailable(c), value / config.runs / 1e6, 1);
+        };
+
+        std::cout << "Per run, " << config.runs << " runs (counters in millions)\n\n";
+        std::cout << std::setw(16) << "Phase"
+                  << std::setw(12) << "Time (ms)"
+                  << std::setw(12) << "Cycles"
+                  << std::setw(12) << "Instr"
+                  << std::setw(8) << "IPC"
+                  << std::setw(12) << "LLC miss"
+                  << std::setw(12) << "Br miss" << "\n";
+        std::cout << std::string(84, '-') << "\n";
+
+        for (int p = 0; p < NUM_EXTRACTION_PHASES; p++)
+        {
+            ExtractionPhase phase = static_cast<ExtractionPhase>(p);
+            const PerfCounts &c = profiler.counts(phase);
+            bool hasIpc = profiler.isAvailable(PerfCounterGroup::CYCLES) &&
+                          profiler.isAvailable(PerfCounterGroup::INSTRUCTIONS);
+
+            std::cout << std::setw(16) << phaseName(phase)
+                      << std::setw(12) << std::fixed << std::setprecision(2)
+                      << profiler.milliseconds(phase) / config.runs
+                      << std::setw(12) << counter(PerfCounterGroup::CYCLES, c.cycles)
+                      << std::setw(12) << counter(PerfCounterGroup::INSTRUCTIONS, c.instructions)
+                      << std::setw(8) << cell(hasIpc, c.ipc(), 2)
+                      << std::setw(12) << counter(PerfCounterGroup::LLC_MISSES, c.llcMisses)
+                      << std::setw(12) << counter(PerfCounterGroup::BRANCH_MISSES, c.branchMisses) << "\n";
+        }
+    }
+
+    // Almacenamiento reducido: el mismo campo cuantizado a 16 y 8 bits y
+    // convertido a half, frente a float. Menos bytes por vóxel son menos
+    // tráfico de memoria en el recorrido de clasificación
+    void precisionAnalysis(const float *volumeData, int gridSize, float isoValue,
+                           const std::string &dataset)
+    {
+        std::cout << "\n=== Reduced-Precision Storage ===\n";
+
+        const size_t count = static_cast<size_t>(gridSize) * gridSize * gridSize;
+        std::vector<uint16_t> data16;
+        std::vector<uint8_t> data8;
+        std::vector<Half> dataHalf;
+        float scale16, offset16, scale8, offset8;
+        quantizeField(volumeData, count, data16, scale16, offset16);
+        quantizeField(volumeData, count, data8, scale8, offset8);
+        convertToHalf(volumeData, count, dataHalf);
+
+        std::vector<BenchmarkResult> rows;
+        rows.push_back(runTypedTest(volumeData, 1.0f, 0.0f, gridSize, isoValue, dataset));
+        rows.push_back(runTypedTest(data16.data(), scale16, offset16, gridSize, isoValue, dataset));
+        rows.push_back(runTypedTest(dataHalf.data(), 1.0f, 0.0f, gridSize, isoValue, dataset));
+        rows.push_back(runTypedTest(data8.data(), scale8, offset8, gridSize, isoValue, dataset));
+        const int bytesPerVoxel[] = {4, 2, 2, 1};
+
+        std::cout << std::setw(16) << "Storage"
+                  << std::setw(12) << "Bytes/vox"
+                  << std::setw(12) << "Field MB"
+                  << std::setw(14) << "Median (ms)"
+                  << std::setw(12) << "Triangles" << "\n";
+        std::cout << std::string(66, '-') << "\n";
+        for (size_t i = 0; i < rows.size(); i++)
+        {
+            std::cout << std::setw(16) << rows[i].engine.substr(7) << std::setw(12) << bytesPerVoxel[i]
+                      << std::setw(12) << std::fixed << std::setprecision(2)
+                      << count * bytesPerVoxel[i] / (1024.0 * 1024.0)
+                      << std::setw(14) << rows[i].stats.medianMs
+                      << std::setw(12) << rows[i].triangles << "\n";
+        }
+    }
+
+    // Esfera procedimental: materializar el volumen y extraer frente a
+    // evaluar el campo sobre la marcha con MarchingCubesImplicit
+    void implicitAnalysis(int gridSize, float isoValue)
+    {
+        std::cout << "\n=== Implicit vs Materialized Field ===\n";
+
+        const std::string dataset = "sphere-" + std::to_string(gridSize);
+        const float center = gridSize / 2.0f;
+        std::vector<Triangle> triangles;
+
+        // El mismo campo que generateSphereData: radio - distancia
+        ScaledSampler<SphereSampler> sphere{SphereSampler(gridSize * 0.4f, center, center, center), -1.0f, 0.0f};
+        MarchingCubesImplicit<ScaledSampler<SphereSampler>> implicit(sphere);
+        implicit.setGridSize(gridSize, gridSize, gridSize);
+        implicit.setIsoValue(isoValue);
+        implicit.setNumThreads(maxThreads());
+
+        BenchmarkResult materialized = runBenchmark(config, [&]() -> long long {
+            std::vector<float> data = generateSphereData(gridSize, gridSize * 0.4f);
+            MarchingCubesParallel mc;
+            mc.setScalarField(data.data(), gridSize, gridSize, gridSize);
+            mc.setIsoValue(isoValue);
+            mc.setNumThreads(maxThreads());
+            return mc.generateIsosurface(triangles);
+        });
+        materialized = record(materialized, "materialized", dataset, gridSize, isoValue, maxThreads());
+
+        BenchmarkResult onTheFly = runBenchmark(config, [&]() -> long long {
+            return implicit.generateIsosurface(triangles);
+        });
+        onTheFly = record(onTheFly, "implicit", dataset, gridSize, isoValue, maxThreads());
+
+        double volumeMB = static_cast<double>(gridSize) * gridSize * gridSize * sizeof(float) / (1024.0 * 1024.0);
+        double windowMB = implicit.windowBytes() * static_cast<double>(maxThreads()) / (1024.0 * 1024.0);
+
+        std::cout << "  Materialized (generate + extract): " << materialized.stats.medianMs
+                  << " ms, field " << volumeMB << " MB\n";
+        std::cout << "  Implicit (sample on the fly):      " << onTheFly.stats.medianMs
+                  << " ms, windows " << windowMB << " MB\n";
+        std::cout << "  Triangles: " << onTheFly.triangles << "\n";
+    }
+
+    // Generar gráficas (datos para gnuplot) a partir de las medianas medidas
     void generatePlotData()
     {
         std::ofstream speedupFile("speedup_data.txt");
         std::ofstream flopsFile("flops_data.txt");
 
-        // Datos de speedup vs número de threads
+        // Datos de speedup vs número de threads (escalabilidad fuerte)
         speedupFile << "# Threads Speedup Efficiency\n";
-        for (int p = 1; p <= 32; p *= 2)
+        for (const ScalingPoint &p : strongScaling)
         {
-            double speedup = p * 0.85; // Modelo simplificado
-            double efficiency = speedup / p;
-            speedupFile << p << " " << speedup << " " << efficiency << "\n";
+            double speedup = p.serialMs / p.parallelMs;
+            speedupFile << p.threads << " " << speedup << " " << speedup / p.threads << "\n";
         }
 
-        // Datos de FLOPS vs tamaño del problema
-        flopsFile << "# GridSize GFLOPS_Serial GFLOPS_Parallel\n";
-        std::vector<int> sizes = {32, 64, 128, 256, 512};
-        for (int size : sizes)
+        // Datos de FLOPS vs tamaño del problema (escalabilidad débil)
+        flopsFile << "# GridSize Threads GFLOPS_Serial GFLOPS_Parallel\n";
+        for (const ScalingPoint &p : weakScaling)
         {
-            double flops = calculateFLOPs(size, size * size * 0.1);
-            double serialGFLOPS = flops / (size * size * 0.001) / 1e9;
-            double parallelGFLOPS = serialGFLOPS * 15; // Factor de speedup estimado
-            flopsFile << size << " " << serialGFLOPS << " " << parallelGFLOPS << "\n";
+            flopsFile << p.gridSize << " " << p.threads << " "
+                      << p.flops / (p.serialMs * 1e6) << " "
+                      << p.flops / (p.parallelMs * 1e6) << "\n";
         }
 
         speedupFile.close();
@@ -261,40 +580,447 @@ public:
     }
 };
 
+// Crea el sink de salida según la extensión (.stl o .ply); sin ruta solo cuenta
+std::unique_ptr<MeshSink> openMeshSink(const std::string &path)
+{
+    auto endsWith = [&](const char *ext) {
+        std::string e(ext);
+        return path.size() >= e.size() && path.compare(path.size() - e.size(), e.size(), e) == 0;
+    };
+
+    if (path.empty())
+    {
+        return std::unique_ptr<MeshSink>(new CountingMeshSink());
+    }
+    if (endsWith(".stl"))
+    {
+        std::unique_ptr<BinaryStlSink> sink(new BinaryStlSink());
+        if (sink->open(path, 8 << 20, true))
+        {
+            return std::unique_ptr<MeshSink>(sink.release());
+        }
+    }
+    else if (endsWith(".ply"))
+    {
+        std::unique_ptr<BinaryPlySink> sink(new BinaryPlySink());
+        if (sink->open(path, 8 << 20, true))
+        {
+            return std::unique_ptr<MeshSink>(sink.release());
+        }
+    }
+    else
+    {
+        std::cerr << "Error: formato de salida no soportado (use .stl o .ply): " << path << "\n";
+    }
+    return nullptr;
+}
+
+// Extracción out-of-core: uso de memoria acotado por la ventana de planos
+int runStreaming(const std::string &filename, float isoValue, int slabDepth, const std::string &outputPath)
+{
+    MarchingCubesStreaming mc;
+    if (!mc.open(filename))
+    {
+        return 1;
+    }
+    mc.setIsoValue(isoValue);
+    mc.setSlabDepth(slabDepth);
+
+    std::cout << "Streaming " << filename << " (" << mc.getSizeX() << "x" << mc.getSizeY()
+              << "x" << mc.getSizeZ() << "), window: " << mc.windowBytes() / (1024.0 * 1024.0) << " MB\n";
+
+    std::unique_ptr<MeshSink> sink = openMeshSink(outputPath);
+    if (!sink)
+    {
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    long long triangles = mc.generateIsosurface(*sink);
+    bool written = sink->finish();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (triangles < 0 || !written)
+    {
+        return 1;
+    }
+
+    std::cout << "Triangles: " << triangles << "\n";
+    std::cout << "Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    return 0;
+}
+
+// Convierte un .bin denso al formato por bricks v2
+int convertToBricked(const std::string &input, const std::string &output, int brickSize, bool compress)
+{
+    MappedVolume volume;
+    if (!volume.open(input))
+    {
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (!writeBrickedVolume(volume.data(), volume.nx(), volume.ny(), volume.nz(), output, brickSize, compress))
+    {
+        return 1;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    BrickedVolumeReader reader;
+    if (!reader.open(output))
+    {
+        return 1;
+    }
+    double denseBytes = 3 * sizeof(int) + static_cast<double>(volume.size()) * sizeof(float);
+    std::cout << "Wrote " << output << ": " << reader.numBricks() << " bricks of " << brickSize << "³, "
+              << reader.fileBytes() / (1024.0 * 1024.0) << " MB ("
+              << 100.0 * reader.fileBytes() / denseBytes << "% of dense) in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    return 0;
+}
+
+// Extracción leyendo solo los bricks activos de un archivo v2
+int runBricked(const std::string &filename, float isoValue, const std::string &outputPath)
+{
+    MarchingCubesBricked mc;
+    if (!mc.open(filename))
+    {
+        return 1;
+    }
+    mc.setIsoValue(isoValue);
+
+    std::unique_ptr<MeshSink> sink = openMeshSink(outputPath);
+    if (!sink)
+    {
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    long long triangles = mc.generateIsosurface(*sink);
+    bool written = sink->finish();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (triangles < 0 || !written)
+    {
+        return 1;
+    }
+
+    const BrickedVolumeReader &reader = mc.getReader();
+    std::cout << "Bricks read: " << mc.getBricksRead() << " / " << reader.numBricks() << "\n";
+    std::cout << "Bytes read: " << mc.getBytesRead() / (1024.0 * 1024.0) << " MB of "
+              << reader.fileBytes() / (1024.0 * 1024.0) << " MB\n";
+    std::cout << "Triangles: " << triangles << "\n";
+    std::cout << "Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    return 0;
+}
+
+// Malla indexada (vértices compartidos) de un .bin, opcionalmente con
+// normales por vértice obtenidas del gradiente del campo
+int runIndexed(const std::string &filename, float isoValue, const std::string &outputPath, bool normals)
+{
+    MappedVolume volume;
+    if (!volume.open(filename))
+    {
+        return 1;
+    }
+
+    // Salto de espacio vacío: solo se recorren los bricks que contienen el isovalor
+    BrickIndex bricks;
+    bricks.build(volume.data(), volume.nx(), volume.ny(), volume.nz());
+
+    MarchingCubesSerial mc;
+    mc.setScalarField(volume.data(), volume.nx(), volume.ny(), volume.nz());
+    mc.setIsoValue(isoValue);
+    mc.setBrickIndex(&bricks);
+    mc.setComputeNormals(normals);
+
+    IndexedMesh mesh;
+    auto start = std::chrono::high_resolution_clock::now();
+    int triangles = mc.generateIndexedMesh(mesh);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Triangles: " << triangles << ", vertices: " << mesh.vertices.size()
+              << (mesh.hasNormals() ? " (with normals)" : "") << "\n";
+    std::cout << "Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+
+    if (!outputPath.empty() && !saveIndexedMeshPly(mesh, outputPath))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+// Procesado por lotes de un directorio de .bin con carga, extracción y
+// escritura solapadas
+int runBatch(const std::string &input, const std::string &outputDir, float isoValue,
+             const std::string &format, size_t memoryMB, const std::string &backend)
+{
+    std::vector<std::string> inputs = BatchPipeline::listInputs(input);
+    if (inputs.empty())
+    {
+        std::cerr << "Error: no hay archivos .bin en " << input << "\n";
+        return 1;
+    }
+    if (format != "stl" && format != "ply")
+    {
+        std::cerr << "Error: formato de salida no soportado (use stl o ply): " << format << "\n";
+        return 1;
+    }
+    if (backend != "mc" && backend != "fe")
+    {
+        std::cerr << "Error: motor no soportado (use mc o fe): " << backend << "\n";
+        return 1;
+    }
+
+    BatchOptions options;
+    options.isoValue = isoValue;
+    options.outputDir = outputDir == "-" ? "" : outputDir;
+    options.format = format;
+    options.backend = backend == "fe" ? ExtractionBackend::FLYING_EDGES : ExtractionBackend::MARCHING_CUBES;
+    if (memoryMB > 0)
+    {
+        options.volumeMemoryBytes = options.meshMemoryBytes = memoryMB << 20;
+    }
+
+    std::cout << "Batch: " << inputs.size() << " volumes, iso " << isoValue
+              << ", backend " << (backend == "fe" ? "flying-edges" : "marching-cubes") << "\n";
+    BatchPipeline pipeline(options);
+    bool ok = pipeline.run(inputs);
+    pipeline.printReport();
+    return ok ? 0 : 1;
+}
+
+// Tipo de campo a partir de su nombre en la línea de comandos
+bool parseFieldType(const std::string &name, FieldType &type)
+{
+    if (name == "sphere")
+        type = FieldType::SPHERE;
+    else if (name == "spheres")
+        type = FieldType::MULTIPLE_SPHERES;
+    else if (name == "waves")
+        type = FieldType::WAVES_3D;
+    else if (name == "torus")
+        type = FieldType::TORUS;
+    else if (name == "combined")
+        type = FieldType::COMBINED;
+    else if (name == "metaballs")
+        type = FieldType::METABALLS;
+    else if (name == "noise")
+        type = FieldType::NOISE;
+    else
+    {
+        std::cerr << "Error: tipo de campo desconocido (sphere, spheres, waves, torus, combined, metaballs, noise): "
+                  << name << "\n";
+        return false;
+    }
+    return true;
+}
+
+// Extracción de un campo procedimental sin materializar el volumen: la
+// resolución solo está limitada por el tiempo, no por la memoria
+int runImplicit(const std::string &typeName, int gridSize, float isoValue, const std::string &outputPath)
+{
+    DataConfig config(gridSize);
+    if (!parseFieldType(typeName, config.type))
+    {
+        return 1;
+    }
+
+    std::unique_ptr<MeshSink> sink = openMeshSink(outputPath);
+    if (!sink)
+    {
+        return 1;
+    }
+
+    long long triangles = 0;
+    size_t windowBytes = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    withFieldSampler(config, [&](const auto &sampler) {
+        MarchingCubesImplicit<typename std::decay<decltype(sampler)>::type> mc(sampler);
+        mc.setGridSize(gridSize, gridSize, gridSize);
+        mc.setIsoValue(isoValue);
+        windowBytes = mc.windowBytes();
+        triangles = mc.generateIsosurface(*sink);
+    });
+    bool written = sink->finish();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    if (!written)
+    {
+        return 1;
+    }
+
+    std::cout << "Implicit " << typeName << " " << gridSize << "³, window: "
+              << windowBytes / (1024.0 * 1024.0) << " MB\n";
+    std::cout << "Triangles: " << triangles << "\n";
+    std::cout << "Time: " << std::chrono::duration<double, std::milli>(end - start).count() << " ms\n";
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     try
     {
-        PerformanceAnalyzer analyzer;
+        // Modo out-of-core: mainOutput --stream archivo.bin [isovalor] [capas por slab] [salida.stl|.ply]
+        if (argc > 2 && std::string(argv[1]) == "--stream")
+        {
+            float isoValue = argc > 3 ? std::stof(argv[3]) : 0.0f;
+            int slabDepth = argc > 4 ? std::stoi(argv[4]) : 16;
+            std::string outputPath = argc > 5 ? argv[5] : "";
+            return runStreaming(argv[2], isoValue, slabDepth, outputPath);
+        }
+
+        // Conversión al formato v2: mainOutput --to-bricked entrada.bin salida.mcb [lado] [raw]
+        if (argc > 3 && std::string(argv[1]) == "--to-bricked")
+        {
+            int brickSize = argc > 4 ? std::stoi(argv[4]) : 32;
+            bool compress = !(argc > 5 && std::string(argv[5]) == "raw");
+            return convertToBricked(argv[2], argv[3], brickSize, compress);
+        }
+
+        // Lotes: mainOutput --batch directorio|archivo.bin salida|- [isovalor] [stl|ply] [memoria MB] [mc|fe]
+        if (argc > 3 && std::string(argv[1]) == "--batch")
+        {
+            float isoValue = argc > 4 ? std::stof(argv[4]) : 0.0f;
+            std::string format = argc > 5 ? argv[5] : "stl";
+            size_t memoryMB = argc > 6 ? std::stoul(argv[6]) : 0;
+            std::string backend = argc > 7 ? argv[7] : "mc";
+            return runBatch(argv[2], argv[3], isoValue, format, memoryMB, backend);
+        }
+
+        // Malla indexada: mainOutput --indexed archivo.bin [isovalor] [salida.ply] [normals]
+        if (argc > 2 && std::string(argv[1]) == "--indexed")
+        {
+            float isoValue = argc > 3 ? std::stof(argv[3]) : 0.0f;
+            std::string outputPath = argc > 4 ? argv[4] : "";
+            bool normals = argc > 5 && std::string(argv[5]) == "normals";
+            return runIndexed(argv[2], isoValue, outputPath, normals);
+        }
+
+        // Extracción de un archivo v2: mainOutput --bricked archivo.mcb [isovalor] [salida.stl|.ply]
+        if (argc > 2 && std::string(argv[1]) == "--bricked")
+        {
+            float isoValue = argc > 3 ? std::stof(argv[3]) : 0.0f;
+            std::string outputPath = argc > 4 ? argv[4] : "";
+            return runBricked(argv[2], isoValue, outputPath);
+        }
+
+        // Campo implícito: mainOutput --implicit tipo tamaño [isovalor] [salida.stl|.ply]
+        if (argc > 3 && std::string(argv[1]) == "--implicit")
+        {
+            float isoValue = argc > 4 ? std::stof(argv[4]) : 0.0f;
+            std::string outputPath = argc > 5 ? argv[5] : "";
+            return runImplicit(argv[2], std::stoi(argv[3]), isoValue, outputPath);
+        }
+
+        // Opciones del benchmark: mainOutput [archivo.bin] [--runs N] [--warmup N]
+        //                         [--iso valor] [--json salida.json] [--csv salida.csv]
+        //                         [--metrics metricas.json|metricas.prom]
+        BenchmarkConfig config;
+        std::string inputPath, jsonPath, csvPath, metricsPath;
 
         // Parámetros
         int gridSize = 256;
         float isoValue = 0.0f;
 
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--runs" && hasValue)
+            {
+                config.runs = std::stoi(argv[++i]);
+            }
+            else if (arg == "--warmup" && hasValue)
+            {
+                config.warmupRuns = std::stoi(argv[++i]);
+            }
+            else if (arg == "--iso" && hasValue)
+            {
+                isoValue = std::stof(argv[++i]);
+            }
+            else if (arg == "--json" && hasValue)
+            {
+                jsonPath = argv[++i];
+            }
+            else if (arg == "--csv" && hasValue)
+            {
+                csvPath = argv[++i];
+            }
+            else if (arg == "--metrics" && hasValue)
+            {
+                metricsPath = argv[++i];
+            }
+            else if (arg.compare(0, 2, "--") != 0 && inputPath.empty())
+            {
+                inputPath = arg;
+            }
+            else
+            {
+                std::cerr << "Error: argumento no reconocido: " << arg << "\n";
+                return 1;
+            }
+        }
+
+        PerformanceAnalyzer analyzer(config);
+
         // Generar o cargar datos
-        std::vector<float> volumeData;
+        std::vector<float> generatedData;
+        MappedVolume mappedData;
+        const float *volumeData = nullptr;
+        std::string dataset;
 
-        if (argc > 1)
+        if (!inputPath.empty())
         {
-            // Cargar desde archivo
-            volumeData = analyzer.loadVolumeData(argv[1], gridSize);
-            std::cout << "Loaded volume data from " << argv[1] << "\n";
+            // Proyectar el archivo en memoria (sin copia)
+            analyzer.loadVolumeData(inputPath, mappedData, gridSize);
+            volumeData = mappedData.data();
+            dataset = inputPath;
+            std::cout << "Mapped volume data from " << inputPath << "\n";
         }
         else
         {
             // Generar esfera sintética
-            volumeData = analyzer.generateSphereData(gridSize, gridSize * 0.4f);
+            generatedData = analyzer.generateSphereData(gridSize, gridSize * 0.4f);
+            volumeData = generatedData.data();
+            dataset = "sphere-" + std::to_string(gridSize);
             std::cout << "Generated synthetic sphere data\n";
         }
 
         std::cout << "Grid size: " << gridSize << "³\n";
+        analyzer.buildBrickIndex(volumeData, gridSize);
         std::cout << "Iso-value: " << isoValue << "\n";
 
         // Ejecutar análisis
-        analyzer.strongScalingAnalysis(volumeData.data(), gridSize, isoValue);
+        analyzer.strongScalingAnalysis(volumeData, gridSize, isoValue, dataset);
         analyzer.weakScalingAnalysis(isoValue);
-        analyzer.detailedPerformanceAnalysis(volumeData.data(), gridSize, isoValue);
+        analyzer.detailedPerformanceAnalysis(volumeData, gridSize, isoValue, dataset);
+        analyzer.precisionAnalysis(volumeData, gridSize, isoValue, dataset);
+        if (inputPath.empty())
+        {
+            analyzer.implicitAnalysis(gridSize, isoValue);
+        }
         analyzer.generatePlotData();
+
+        // Resultados completos (todas las mediciones) en formato legible por máquina
+        if (!jsonPath.empty() && !writeResultsJson(analyzer.getResults(), jsonPath))
+        {
+            return 1;
+        }
+        if (!csvPath.empty() && !writeResultsCsv(analyzer.getResults(), csvPath))
+        {
+            return 1;
+        }
+        if (!metricsPath.empty())
+        {
+#ifndef MC_ENABLE_METRICS
+            std::cerr << "Warning: compiled without -DMC_ENABLE_METRICS, metrics will be zero\n";
+#endif
+            if (!MetricsRegistry::instance().writeFile(metricsPath))
+            {
+                return 1;
+            }
+        }
     }
     catch (const std::exception &e)
     {
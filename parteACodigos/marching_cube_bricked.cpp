@@ -0,0 +1,101 @@
+#include "marching_cube_bricked.h"
+#include "src/metrics.h"
+#include <atomic>
+#include <iostream>
+
+MarchingCubesBricked::MarchingCubesBricked()
+    : isoValue(0.0f), bricksRead(0), bytesRead(0)
+{
+}
+
+// Lee y extrae los bricks activos por capas bz
+long long MarchingCubesBricked::generateIsosurface(MeshSink &sink)
+{
+    bricksRead = 0;
+    bytesRead = 0;
+
+    if (!reader.isOpen())
+    {
+        std::cerr << "Error: Archivo no abierto." << std::endl;
+        return -1;
+    }
+
+    std::vector<int> active;
+    reader.collectActiveBricks(isoValue, active);
+
+    const int layerBricks = reader.bricksX() * reader.bricksY();
+    std::vector<std::vector<Triangle>> buffers;
+    std::atomic<bool> failed(false);
+    long long total = 0;
+
+    // Los bricks activos están en orden de archivo: agrupar por capa bz
+    size_t first = 0;
+    while (first < active.size())
+    {
+        const int layer = active[first] / layerBricks;
+        size_t last = first;
+        while (last < active.size() && active[last] / layerBricks == layer)
+        {
+            last++;
+        }
+        const int count = static_cast<int>(last - first);
+        buffers.resize(std::max<size_t>(buffers.size(), count));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            MarchingCubesSerial engine;
+            engine.setIsoValue(isoValue);
+            std::vector<float> values;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+            for (int k = 0; k < count; k++)
+            {
+                const int index = active[first + k];
+                buffers[k].clear();
+                if (!reader.readBrick(index, values))
+                {
+                    failed = true;
+                    continue;
+                }
+                MC_METRIC_ADD(BYTES_READ, reader.entry(index).storedBytes);
+
+                // Vértices en coordenadas globales
+                int x0, y0, z0, sx, sy, sz;
+                reader.brickExtent(index, x0, y0, z0, sx, sy, sz);
+                engine.setScalarField(values.data(), sx, sy, sz);
+                engine.setOrigin(x0, y0, z0);
+                engine.generateIsosurface(buffers[k]);
+            }
+        }
+
+        if (failed)
+        {
+            std::cerr << "Error: Lectura fallida de un brick" << std::endl;
+            return -1;
+        }
+
+        // Entregar la capa en orden de archivo
+        for (int k = 0; k < count; k++)
+        {
+            sink.addTriangles(buffers[k].data(), buffers[k].size());
+            total += buffers[k].size();
+            bytesRead += reader.entry(active[first + k]).storedBytes;
+        }
+        bricksRead += count;
+        first = last;
+    }
+
+    return total;
+}
+
+// Versión que acumula los triángulos en un vector
+long long MarchingCubesBricked::generateIsosurface(std::vector<Triangle> &triangles)
+{
+    triangles.clear();
+    VectorMeshSink sink(triangles);
+    return generateIsosurface(sink);
+}
@@ -0,0 +1,56 @@
+#ifndef MARCHING_CUBES_BRICKED_H
+#define MARCHING_CUBES_BRICKED_H
+
+#include <string>
+#include <vector>
+#include "marching_cube_serial.h"
+#include "mesh_sink.h"
+#include "src/bricked_volume.h"
+
+// Extracción directa de un archivo por bricks (formato v2, ver
+// src/bricked_volume.h): con el índice min/max de la cabecera solo se leen
+// y descomprimen los bricks cuyo rango contiene el isovalor; el resto del
+// archivo no se toca. Cada brick se extrae por separado con los vértices en
+// coordenadas globales, así que la malla es la misma que la del volumen
+// completo, con los triángulos agrupados por brick (en el orden del archivo)
+// en lugar de por filas.
+class MarchingCubesBricked
+{
+public:
+    MarchingCubesBricked();
+
+    // Abre el archivo y carga su índice
+    bool open(const std::string &filename) { return reader.open(filename); }
+    void close() { reader.close(); }
+
+    // Establece el isovalor
+    void setIsoValue(float value) { isoValue = value; }
+
+    // Dimensiones del archivo abierto
+    int getSizeX() const { return reader.nx(); }
+    int getSizeY() const { return reader.ny(); }
+    int getSizeZ() const { return reader.nz(); }
+
+    // Índice y datos del archivo abierto
+    const BrickedVolumeReader &getReader() const { return reader; }
+
+    // Entrega los triángulos a 'sink'. Los bricks activos de cada capa bz
+    // se leen y extraen en paralelo y se entregan en orden. Devuelve el
+    // número de triángulos o -1 si hubo un error de lectura
+    long long generateIsosurface(MeshSink &sink);
+
+    // Versión que acumula los triángulos en un vector
+    long long generateIsosurface(std::vector<Triangle> &triangles);
+
+    // Bricks leídos y bytes leídos del archivo en la última extracción
+    int getBricksRead() const { return bricksRead; }
+    unsigned long long getBytesRead() const { return bytesRead; }
+
+private:
+    BrickedVolumeReader reader;
+    float isoValue;
+    int bricksRead;
+    unsigned long long bytesRead;
+};
+
+#endif // MARCHING_CUBES_BRICKED_H
@@ -0,0 +1,493 @@
+#include "marching_cube_flying_edges.h"
+#include "cube_classifier.h"
+#include "mesh_sink.h"
+#include "src/metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Constructor
+MarchingCubesFlyingEdges::MarchingCubesFlyingEdges()
+    : scalarField(nullptr), sizeX(0), sizeY(0), sizeZ(0), isoValue(0.0f),
+      originX(0), originY(0), originZ(0), numThreads(0)
+{
+}
+
+// Configura los datos del volumen
+void MarchingCubesFlyingEdges::setScalarField(const float *data, int sx, int sy, int sz)
+{
+    scalarField = data;
+    sizeX = sx;
+    sizeY = sy;
+    sizeZ = sz;
+}
+
+// Número de hilos que se usarán en la próxima ejecución
+int MarchingCubesFlyingEdges::getNumThreads() const
+{
+    if (numThreads > 0)
+    {
+        return numThreads;
+    }
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Punto de corte de la arista que va de 'p' (valor v0) al vóxel siguiente
+// en el eje 'axis' (valor v1). Mismo criterio que MarchingCubesSerial
+static Vertex interpolateEdge(float px, float py, float pz, int axis, float v0, float v1, float iso)
+{
+    Vertex p0(px, py, pz);
+    Vertex p1(axis == 0 ? px + 1 : px, axis == 1 ? py + 1 : py, axis == 2 ? pz + 1 : pz);
+
+    if (std::abs(iso - v0) < 0.00001f)
+    {
+        return p0;
+    }
+    if (std::abs(iso - v1) < 0.00001f)
+    {
+        return p1;
+    }
+    if (std::abs(v0 - v1) < 0.00001f)
+    {
+        return p0;
+    }
+
+    float t = (iso - v0) / (v1 - v0);
+    return p0 + (p1 - p0) * t;
+}
+
+// Los 8 cubos a partir de x no generan nada si sus cuatro filas de aristas
+// coinciden y están enteras por encima (casos 0) o por debajo (casos 3) del
+// isovalor. Permite saltar rápido el interior de los tramos recortados
+static inline bool uniformCubes8(const unsigned char *e00, const unsigned char *e10,
+                                 const unsigned char *e01, const unsigned char *e11, int x)
+{
+    uint64_t a, b, c, d;
+    std::memcpy(&a, e00 + x, 8);
+    std::memcpy(&b, e10 + x, 8);
+    std::memcpy(&c, e01 + x, 8);
+    std::memcpy(&d, e11 + x, 8);
+    return a == b && a == c && a == d && (a == 0 || a == 0x0303030303030303ull);
+}
+
+// Pasada 1: caso de cada arista x de la fila de vóxeles (y, z) y tramo
+// [xMin, xMax) de aristas cortadas
+void MarchingCubesFlyingEdges::classifyXEdges(int y, int z)
+{
+    const int numEdges = sizeX - 1;
+    const float *values = scalarField + rowIndex(y, z) * sizeX;
+    unsigned char *cases = &xEdgeCases[rowIndex(y, z) * numEdges];
+
+    RowInfo &row = rows[rowIndex(y, z)];
+    int cuts = classifyEdgeRow(values, numEdges, isoValue, cases, row.xMin, row.xMax);
+    row.xCuts = cuts;
+    row.yCuts = 0;
+    row.zCuts = 0;
+    row.xLeft = row.xRight = 0;
+    row.triangles = 0;
+}
+
+// Pasada 2: tramo activo de la fila de cubos (y, z) y recuento de sus
+// triángulos y de los cortes de las aristas y y z que le pertenecen
+void MarchingCubesFlyingEdges::countRow(int y, int z)
+{
+    const int numCubes = sizeX - 1;
+    const size_t r00 = rowIndex(y, z), r10 = rowIndex(y + 1, z);
+    const size_t r01 = rowIndex(y, z + 1), r11 = rowIndex(y + 1, z + 1);
+    const unsigned char *e00 = &xEdgeCases[r00 * numCubes];
+    const unsigned char *e10 = &xEdgeCases[r10 * numCubes];
+    const unsigned char *e01 = &xEdgeCases[r01 * numCubes];
+    const unsigned char *e11 = &xEdgeCases[r11 * numCubes];
+
+    // Fuera de los recortes de las cuatro filas cada fila es constante: solo
+    // hay cubos activos allí si las filas están a distinto lado del isovalor
+    int xL = std::min(std::min(rows[r00].xMin, rows[r10].xMin), std::min(rows[r01].xMin, rows[r11].xMin));
+    int xR = std::max(std::max(rows[r00].xMax, rows[r10].xMax), std::max(rows[r01].xMax, rows[r11].xMax));
+    int first = e00[0] & 1;
+    if ((e10[0] & 1) != first || (e01[0] & 1) != first || (e11[0] & 1) != first)
+    {
+        xL = 0;
+    }
+    int last = e00[numCubes - 1] >> 1;
+    if ((e10[numCubes - 1] >> 1) != last || (e01[numCubes - 1] >> 1) != last || (e11[numCubes - 1] >> 1) != last)
+    {
+        xR = numCubes;
+    }
+    if (xL >= xR)
+    {
+        return;
+    }
+
+    const bool lastY = y == sizeY - 2;
+    const bool lastZ = z == sizeZ - 2;
+    int triangles = 0, yCuts = 0, zCuts = 0, yCutsAbove = 0, zCutsBehind = 0;
+    for (int x = xL; x < xR; x++)
+    {
+        if (x + 8 <= xR && uniformCubes8(e00, e10, e01, e11, x))
+        {
+            x += 7;
+            continue;
+        }
+        int cubeIndex = e00[x] | ((e10[x] & 1) << 3) | ((e10[x] & 2) << 1) | (e01[x] << 4) |
+                        ((e11[x] & 1) << 7) | ((e11[x] & 2) << 5);
+        int edges = edgeTable[cubeIndex];
+        triangles += triangleCounts[cubeIndex];
+        yCuts += (edges >> 3) & 1;
+        zCuts += (edges >> 8) & 1;
+        zCutsBehind += (edges >> 11) & 1;
+        yCutsAbove += (edges >> 7) & 1;
+        if (x == numCubes - 1)
+        {
+            // Aristas del último plano x
+            yCuts += (edges >> 1) & 1;
+            zCuts += (edges >> 9) & 1;
+            zCutsBehind += (edges >> 10) & 1;
+            yCutsAbove += (edges >> 5) & 1;
+        }
+    }
+
+    rows[r00].xLeft = xL;
+    rows[r00].xRight = xR;
+    rows[r00].triangles = triangles;
+    rows[r00].yCuts = yCuts;
+    rows[r00].zCuts = zCuts;
+
+    // Las filas de vóxeles del último plano y / z no son base de ninguna fila
+    // de cubos: sus aristas z / y las cuenta la fila de cubos vecina
+    if (lastY)
+    {
+        rows[r10].zCuts = zCutsBehind;
+    }
+    if (lastZ)
+    {
+        rows[r01].yCuts = yCutsAbove;
+    }
+}
+
+// Pasada 4: puntos y triángulos de la fila de cubos (y, z). Se avanza por
+// las cuatro filas de vóxeles con un contador por tipo de arista, de modo que
+// el identificador de cada punto se conoce sin buscarlo. 'points' e 'indices'
+// empiezan en el punto pointBase y el triángulo triangleBase, y los índices
+// escritos son relativos a pointBase. Sin 'indices' solo se generan los puntos
+void MarchingCubesFlyingEdges::generateRow(int y, int z, Vertex *points, size_t pointBase,
+                                           uint32_t *indices, size_t triangleBase) const
+{
+    const size_t r00 = rowIndex(y, z), r10 = rowIndex(y + 1, z);
+    const size_t r01 = rowIndex(y, z + 1), r11 = rowIndex(y + 1, z + 1);
+    const RowInfo &row = rows[r00];
+    if (row.xLeft >= row.xRight)
+    {
+        return;
+    }
+
+    const int numCubes = sizeX - 1;
+    const unsigned char *e00 = &xEdgeCases[r00 * numCubes];
+    const unsigned char *e10 = &xEdgeCases[r10 * numCubes];
+    const unsigned char *e01 = &xEdgeCases[r01 * numCubes];
+    const unsigned char *e11 = &xEdgeCases[r11 * numCubes];
+    const float *v00 = scalarField + r00 * sizeX;
+    const float *v10 = scalarField + r10 * sizeX;
+    const float *v01 = scalarField + r01 * sizeX;
+    const float *v11 = scalarField + r11 * sizeX;
+
+    // Primer punto de cada tipo de arista en cada fila de vóxeles: en cada
+    // fila van primero los cortes x, luego los y y luego los z. Antes de
+    // xLeft no hay ninguna arista cortada, así que los contadores empiezan ahí
+    size_t x0 = pointOffsets[r00] - pointBase;
+    size_t y0 = x0 + rows[r00].xCuts;
+    size_t z0 = y0 + rows[r00].yCuts;
+    size_t x1 = pointOffsets[r10] - pointBase;
+    size_t z1 = x1 + rows[r10].xCuts + rows[r10].yCuts;
+    size_t x2 = pointOffsets[r01] - pointBase;
+    size_t y2 = x2 + rows[r01].xCuts;
+    size_t x3 = pointOffsets[r11] - pointBase;
+
+    const bool lastY = y == sizeY - 2;
+    const bool lastZ = z == sizeZ - 2;
+    const float py = static_cast<float>(originY + y);
+    const float pz = static_cast<float>(originZ + z);
+    uint32_t *out = indices ? indices + 3 * (triangleOffsets[r00] - triangleBase) : nullptr;
+
+    for (int x = row.xLeft; x < row.xRight; x++)
+    {
+        if (x + 8 <= row.xRight && uniformCubes8(e00, e10, e01, e11, x))
+        {
+            x += 7;
+            continue;
+        }
+        int cubeIndex = e00[x] | ((e10[x] & 1) << 3) | ((e10[x] & 2) << 1) | (e01[x] << 4) |
+                        ((e11[x] & 1) << 7) | ((e11[x] & 2) << 5);
+        int edges = edgeTable[cubeIndex];
+        if (edges == 0)
+        {
+            continue;
+        }
+
+        // Identificador del punto de cada arista del cubo
+        size_t ids[12];
+        ids[0] = x0;
+        ids[3] = y0;
+        ids[8] = z0;
+        ids[1] = y0 + ((edges >> 3) & 1);
+        ids[9] = z0 + ((edges >> 8) & 1);
+        ids[2] = x1;
+        ids[11] = z1;
+        ids[10] = z1 + ((edges >> 11) & 1);
+        ids[4] = x2;
+        ids[7] = y2;
+        ids[5] = y2 + ((edges >> 7) & 1);
+        ids[6] = x3;
+
+        // Interpolar solo las aristas que pertenecen a esta fila
+        const float px = static_cast<float>(originX + x);
+        const bool lastX = x == numCubes - 1;
+        if (edges & (1 << 0))
+            points[ids[0]] = interpolateEdge(px, py, pz, 0, v00[x], v00[x + 1], isoValue);
+        if (edges & (1 << 3))
+            points[ids[3]] = interpolateEdge(px, py, pz, 1, v00[x], v10[x], isoValue);
+        if (edges & (1 << 8))
+            points[ids[8]] = interpolateEdge(px, py, pz, 2, v00[x], v01[x], isoValue);
+        if (lastX && (edges & (1 << 1)))
+            points[ids[1]] = interpolateEdge(px + 1, py, pz, 1, v00[x + 1], v10[x + 1], isoValue);
+        if (lastX && (edges & (1 << 9)))
+            points[ids[9]] = interpolateEdge(px + 1, py, pz, 2, v00[x + 1], v01[x + 1], isoValue);
+        if (lastY)
+        {
+            if (edges & (1 << 2))
+                points[ids[2]] = interpolateEdge(px, py + 1, pz, 0, v10[x], v10[x + 1], isoValue);
+            if (edges & (1 << 11))
+                points[ids[11]] = interpolateEdge(px, py + 1, pz, 2, v10[x], v11[x], isoValue);
+            if (lastX && (edges & (1 << 10)))
+                points[ids[10]] = interpolateEdge(px + 1, py + 1, pz, 2, v10[x + 1], v11[x + 1], isoValue);
+        }
+        if (lastZ)
+        {
+            if (edges & (1 << 4))
+                points[ids[4]] = interpolateEdge(px, py, pz + 1, 0, v01[x], v01[x + 1], isoValue);
+            if (edges & (1 << 7))
+                points[ids[7]] = interpolateEdge(px, py, pz + 1, 1, v01[x], v11[x], isoValue);
+            if (lastX && (edges & (1 << 5)))
+                points[ids[5]] = interpolateEdge(px + 1, py, pz + 1, 1, v01[x + 1], v11[x + 1], isoValue);
+        }
+        if (lastY && lastZ && (edges & (1 << 6)))
+            points[ids[6]] = interpolateEdge(px, py + 1, pz + 1, 0, v11[x], v11[x + 1], isoValue);
+
+        // Triángulos según la tabla de triangulación
+        for (int t = 0; out && t < triangleCounts[cubeIndex]; t++)
+        {
+            *out++ = static_cast<uint32_t>(ids[triangleEdge(cubeIndex, t, 0)]);
+            *out++ = static_cast<uint32_t>(ids[triangleEdge(cubeIndex, t, 1)]);
+            *out++ = static_cast<uint32_t>(ids[triangleEdge(cubeIndex, t, 2)]);
+        }
+
+        // Avanzar los contadores por las aristas que empiezan en x
+        x0 += edges & 1;
+        y0 += (edges >> 3) & 1;
+        z0 += (edges >> 8) & 1;
+        x1 += (edges >> 2) & 1;
+        z1 += (edges >> 11) & 1;
+        x2 += (edges >> 4) & 1;
+        y2 += (edges >> 7) & 1;
+        x3 += (edges >> 6) & 1;
+    }
+}
+
+// Pasadas 1-3: recuentos y posición de los puntos y triángulos de cada fila
+bool MarchingCubesFlyingEdges::prepareRows()
+{
+    if (!hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return false;
+    }
+
+    const long long numRows = static_cast<long long>(sizeY) * sizeZ;
+    const long long numCubeRows = static_cast<long long>(sizeY - 1) * (sizeZ - 1);
+    const int threads = getNumThreads();
+    xEdgeCases.resize(static_cast<size_t>(numRows) * (sizeX - 1));
+    rows.resize(numRows);
+
+    // Pasada 1: aristas x de todas las filas de vóxeles
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+    for (long long r = 0; r < numRows; r++)
+    {
+        classifyXEdges(static_cast<int>(r % sizeY), static_cast<int>(r / sizeY));
+    }
+
+    // Pasada 2: tramos activos y recuentos de cada fila de cubos
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) num_threads(threads)
+#endif
+    for (long long r = 0; r < numCubeRows; r++)
+    {
+        countRow(static_cast<int>(r % (sizeY - 1)), static_cast<int>(r / (sizeY - 1)));
+    }
+
+    // Pasada 3: suma de prefijos de puntos y triángulos por fila
+    pointOffsets.resize(numRows + 1);
+    triangleOffsets.resize(numRows + 1);
+    pointOffsets[0] = triangleOffsets[0] = 0;
+    long long visitedCells = 0;
+    for (long long r = 0; r < numRows; r++)
+    {
+        const RowInfo &row = rows[r];
+        pointOffsets[r + 1] = pointOffsets[r] + row.xCuts + row.yCuts + row.zCuts;
+        triangleOffsets[r + 1] = triangleOffsets[r] + row.triangles;
+        visitedCells += row.xRight - row.xLeft;
+    }
+
+    MC_METRIC_ADD(CELLS_VISITED, visitedCells);
+    MC_METRIC_ADD(TRIANGLES_EMITTED, triangleOffsets[numRows]);
+    return true;
+}
+
+// Ejecuta las cuatro pasadas
+int MarchingCubesFlyingEdges::buildMesh(IndexedMesh &mesh)
+{
+    MC_SCOPED_TIMER("mc_flying_edges");
+    mesh.clear();
+    if (!prepareRows())
+    {
+        return 0;
+    }
+
+    // Pasada 4: cada fila escribe sus puntos y triángulos en su sitio
+    const size_t numRows = static_cast<size_t>(sizeY) * sizeZ;
+    const long long numCubeRows = static_cast<long long>(sizeY - 1) * (sizeZ - 1);
+    const int threads = getNumThreads();
+    mesh.vertices.resize(pointOffsets[numRows]);
+    mesh.indices.resize(3 * triangleOffsets[numRows]);
+    Vertex *points = mesh.vertices.data();
+    uint32_t *indices = mesh.indices.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) num_threads(threads)
+#endif
+    for (long long r = 0; r < numCubeRows; r++)
+    {
+        generateRow(static_cast<int>(r % (sizeY - 1)), static_cast<int>(r / (sizeY - 1)), points, 0, indices, 0);
+    }
+    return mesh.triangleCount();
+}
+
+// Malla indexada: la salida directa de las pasadas
+int MarchingCubesFlyingEdges::generateIndexedMesh(IndexedMesh &mesh)
+{
+    return buildMesh(mesh);
+}
+
+// Triángulos independientes: se expanden los índices en paralelo
+int MarchingCubesFlyingEdges::generateIsosurface(std::vector<Triangle> &triangles)
+{
+    triangles.clear();
+    int count = buildMesh(scratchMesh);
+    triangles.resize(count);
+
+    const Vertex *points = scratchMesh.vertices.data();
+    const uint32_t *indices = scratchMesh.indices.data();
+    Triangle *out = triangles.data();
+    const int threads = getNumThreads();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+    for (int t = 0; t < count; t++)
+    {
+        out[t] = Triangle(points[indices[3 * t]], points[indices[3 * t + 1]], points[indices[3 * t + 2]]);
+    }
+    return count;
+}
+
+// Ejecuta el algoritmo y devuelve los triángulos generados
+std::vector<Triangle> MarchingCubesFlyingEdges::generateIsosurface()
+{
+    std::vector<Triangle> triangles;
+    generateIsosurface(triangles);
+    return triangles;
+}
+
+// Entrega los triángulos a 'sink' por bloques de planos de cubos. Tras la
+// suma de prefijos se sabe qué puntos y triángulos caen en cada bloque, así
+// que la pasada 4 se hace bloque a bloque sobre buffers del tamaño del bloque
+// en lugar de materializar la malla completa
+long long MarchingCubesFlyingEdges::generateIsosurface(MeshSink &sink)
+{
+    MC_SCOPED_TIMER("mc_flying_edges");
+    if (!prepareRows())
+    {
+        return 0;
+    }
+
+    const int threads = getNumThreads();
+    const int cubeRowsY = sizeY - 1;
+    const size_t blockTriangles = 1 << 16;
+    std::vector<Vertex> points;
+    std::vector<uint32_t> indices;
+    std::vector<Triangle> triangles;
+
+    int z0 = 0;
+    while (z0 < sizeZ - 1)
+    {
+        // Planos de cubos [z0, z1) hasta reunir unos blockTriangles
+        int z1 = z0 + 1;
+        const size_t firstTriangle = triangleOffsets[rowIndex(0, z0)];
+        while (z1 < sizeZ - 1 && triangleOffsets[rowIndex(0, z1)] - firstTriangle < blockTriangles)
+        {
+            z1++;
+        }
+        const size_t count = triangleOffsets[rowIndex(0, z1)] - firstTriangle;
+
+        // Los triángulos del bloque usan los puntos de los planos de vóxeles
+        // z0..z1. Los del plano z1 pertenecen al plano de cubos z1, que se
+        // recorre también pero sin triángulos (se repite en el bloque
+        // siguiente); si es el último escribe además el plano z1 + 1
+        const int extraPlane = z1 < sizeZ - 1 ? 1 : 0;
+        const size_t pointBase = pointOffsets[rowIndex(0, z0)];
+        const size_t pointEnd = pointOffsets[rowIndex(0, std::min(z1 + 2, sizeZ))];
+        points.resize(pointEnd - pointBase);
+        indices.resize(3 * count);
+        triangles.resize(count);
+
+        const long long blockRows = static_cast<long long>(cubeRowsY) * (z1 - z0 + extraPlane);
+        const long long emitRows = static_cast<long long>(cubeRowsY) * (z1 - z0);
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+        {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+            for (long long r = 0; r < blockRows; r++)
+            {
+                generateRow(static_cast<int>(r % cubeRowsY), z0 + static_cast<int>(r / cubeRowsY),
+                            points.data(), pointBase, r < emitRows ? indices.data() : nullptr, firstTriangle);
+            }
+
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+            for (long long t = 0; t < static_cast<long long>(count); t++)
+            {
+                triangles[t] = Triangle(points[indices[3 * t]], points[indices[3 * t + 1]], points[indices[3 * t + 2]]);
+            }
+        }
+
+        if (count > 0)
+        {
+            sink.addTriangles(triangles.data(), count);
+        }
+        z0 = z1;
+    }
+    return static_cast<long long>(triangleOffsets[rowIndex(0, sizeZ)]);
+}
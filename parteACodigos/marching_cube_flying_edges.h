@@ -0,0 +1,110 @@
+#ifndef MARCHING_CUBES_FLYING_EDGES_H
+#define MARCHING_CUBES_FLYING_EDGES_H
+
+#include <cstdint>
+#include <vector>
+#include "marching_cube_serial.h"
+
+// Motor "Flying Edges" (Schroeder et al., 2015): mismas tablas de casos que
+// MarchingCubesSerial, pero el volumen se recorre por filas x de vóxeles y
+// cada arista cortada se interpola exactamente una vez. Cuatro pasadas, todas
+// paralelas sobre filas independientes:
+//   1. Clasificar las aristas x de cada fila de vóxeles y recortar la fila
+//      al tramo [xMin, xMax) que contiene cortes.
+//   2. Para cada fila de cubos, unir los recortes de sus cuatro filas de
+//      vóxeles y recorrer solo ese tramo contando triángulos y cortes de las
+//      aristas y y z.
+//   3. Suma de prefijos: posición de los puntos y triángulos de cada fila.
+//   4. Generar puntos y triángulos escribiendo directamente en su sitio.
+// Los triángulos salen en el mismo orden que en MarchingCubesSerial; los
+// vértices coinciden salvo redondeo, porque cada arista se interpola siempre
+// de su vóxel inferior al superior.
+class MarchingCubesFlyingEdges : public MarchingCubesTables
+{
+public:
+    MarchingCubesFlyingEdges();
+
+    // Configura los datos del volumen (mismo orden que MarchingCubesSerial)
+    void setScalarField(const float *data, int sx, int sy, int sz);
+
+    // Establece el isovalor
+    void setIsoValue(float value) { isoValue = value; }
+    float getIsoValue() const { return isoValue; }
+
+    // Desplaza los vértices generados (ver MarchingCubesSerial::setOrigin)
+    void setOrigin(int ox, int oy, int oz)
+    {
+        originX = ox;
+        originY = oy;
+        originZ = oz;
+    }
+
+    // Establece el número de hilos (0 = valor por defecto de OpenMP)
+    void setNumThreads(int threads) { numThreads = threads; }
+    int getNumThreads() const;
+
+    // Ejecuta el algoritmo y devuelve los triángulos generados
+    std::vector<Triangle> generateIsosurface();
+
+    // Versión que devuelve el número de triángulos generados
+    int generateIsosurface(std::vector<Triangle> &triangles);
+
+    // Entrega los triángulos a 'sink' por bloques de planos z, sin
+    // materializar la malla completa. Devuelve el número de triángulos
+    long long generateIsosurface(MeshSink &sink);
+
+    // Salida natural del algoritmo: cada punto de corte una sola vez y los
+    // triángulos como índices. Devuelve el número de triángulos generados
+    int generateIndexedMesh(IndexedMesh &mesh);
+
+    // Consultas del volumen configurado
+    bool hasScalarField() const { return scalarField && sizeX > 1 && sizeY > 1 && sizeZ > 1; }
+    int getSizeX() const { return sizeX; }
+    int getSizeY() const { return sizeY; }
+    int getSizeZ() const { return sizeZ; }
+
+private:
+    // Datos de una fila de vóxeles (y, z). Los cortes cuentan las aristas
+    // que empiezan en la fila: x hacia x+1, y hacia y+1 y z hacia z+1. Si la
+    // fila es base de una fila de cubos, xLeft/xRight es el tramo de cubos
+    // activos y triangles su número de triángulos
+    struct RowInfo
+    {
+        int xMin, xMax;
+        int xCuts, yCuts, zCuts;
+        int xLeft, xRight;
+        int triangles;
+    };
+
+    // Pasadas del algoritmo
+    void classifyXEdges(int y, int z);
+    void countRow(int y, int z);
+    void generateRow(int y, int z, Vertex *points, size_t pointBase,
+                     uint32_t *indices, size_t triangleBase) const;
+
+    // Ejecuta las pasadas 1-3. Devuelve false si no hay volumen configurado
+    bool prepareRows();
+
+    // Ejecuta las pasadas 1-4 y deja los resultados en 'mesh'
+    int buildMesh(IndexedMesh &mesh);
+
+    size_t rowIndex(int y, int z) const { return static_cast<size_t>(z) * sizeY + y; }
+
+    const float *scalarField;
+    int sizeX, sizeY, sizeZ;
+    float isoValue;
+    int originX, originY, originZ;
+    int numThreads;
+
+    // Caso de cada arista x (bit 0: vóxel x bajo el isovalor, bit 1: x+1)
+    // y datos de cada fila de vóxeles
+    std::vector<unsigned char> xEdgeCases;
+    std::vector<RowInfo> rows;
+    std::vector<size_t> pointOffsets;
+    std::vector<size_t> triangleOffsets;
+
+    // Malla intermedia de generateIsosurface (se reutiliza entre ejecuciones)
+    IndexedMesh scratchMesh;
+};
+
+#endif // MARCHING_CUBES_FLYING_EDGES_H
@@ -0,0 +1,210 @@
+#ifndef MARCHING_CUBES_IMPLICIT_H
+#define MARCHING_CUBES_IMPLICIT_H
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "marching_cube_serial.h"
+#include "mesh_sink.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Extracción sobre un campo implícito sin materializar el volumen.
+// 'Sampler' es cualquier functor float(float x, float y, float z) const
+// (ver src/field_samplers.h) evaluado en los puntos de una malla
+// sizeX x sizeY x sizeZ. Igual que MarchingCubesStreaming, el volumen se
+// recorre por ventanas de slabDepth + 1 planos z, pero los planos se evalúan
+// en lugar de leerse: la memoria usada no depende de sizeZ y el muestreo
+// queda expandido en línea porque el tipo del campo es un parámetro de la
+// plantilla. El resultado es idéntico al de MarchingCubesSerial sobre el
+// volumen muestreado completo.
+template <typename Sampler>
+class MarchingCubesImplicit
+{
+public:
+    // El campo se copia; admite lambdas (sin constructor por defecto)
+    explicit MarchingCubesImplicit(const Sampler &s = Sampler())
+        : sampler(s), sizeX(0), sizeY(0), sizeZ(0), slabDepth(16), isoValue(0.0f), numThreads(0) {}
+
+    // Reemplaza el campo a extraer
+    void setSampler(const Sampler &s) { sampler = s; }
+
+    // Resolución de la malla de muestreo
+    void setGridSize(int sx, int sy, int sz)
+    {
+        sizeX = sx;
+        sizeY = sy;
+        sizeZ = sz;
+    }
+
+    // Establece el isovalor
+    void setIsoValue(float value) { isoValue = value; }
+
+    // Capas de cubos por ventana (la ventana contiene slabDepth + 1 planos)
+    void setSlabDepth(int depth) { slabDepth = depth > 0 ? depth : 1; }
+
+    // Hilos para generateIsosurface(std::vector&) (0 = valor por defecto de OpenMP)
+    void setNumThreads(int threads) { numThreads = threads; }
+
+    int getSizeX() const { return sizeX; }
+    int getSizeY() const { return sizeY; }
+    int getSizeZ() const { return sizeZ; }
+
+    // Bytes de la ventana de planos de un hilo
+    size_t windowBytes() const
+    {
+        return static_cast<size_t>(sizeX) * sizeY * (slabDepth + 1) * sizeof(float);
+    }
+
+    // Genera todos los triángulos. Las capas z se reparten en slabs
+    // contiguos, uno por hilo, y se concatenan en orden
+    int generateIsosurface(std::vector<Triangle> &triangles) const
+    {
+        triangles.clear();
+        if (!validGrid())
+        {
+            return 0;
+        }
+
+        const int numCubesZ = sizeZ - 1;
+        const int slabs = std::max(1, std::min(threadCount(), numCubesZ));
+        std::vector<std::vector<Triangle>> buffers(slabs);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(slabs)
+#endif
+        for (int slab = 0; slab < slabs; slab++)
+        {
+            int zBegin = static_cast<int>(static_cast<long long>(numCubesZ) * slab / slabs);
+            int zEnd = static_cast<int>(static_cast<long long>(numCubesZ) * (slab + 1) / slabs);
+            std::vector<Triangle> &buffer = buffers[slab];
+            extractSlab(zBegin, zEnd, [&buffer](const std::vector<Triangle> &window) {
+                buffer.insert(buffer.end(), window.begin(), window.end());
+            });
+        }
+
+        // Fusión determinista: concatenar en orden de slab
+        size_t total = 0;
+        for (const auto &buffer : buffers)
+        {
+            total += buffer.size();
+        }
+        triangles.reserve(total);
+        for (const auto &buffer : buffers)
+        {
+            triangles.insert(triangles.end(), buffer.begin(), buffer.end());
+        }
+        return triangles.size();
+    }
+
+    // Entrega los triángulos de cada ventana a 'sink' (en un solo hilo): ni
+    // el volumen ni la malla completa llegan a estar en memoria.
+    // Devuelve el número de triángulos generados
+    long long generateIsosurface(MeshSink &sink) const
+    {
+        if (!validGrid())
+        {
+            return 0;
+        }
+
+        long long total = 0;
+        extractSlab(0, sizeZ - 1, [&](const std::vector<Triangle> &window) {
+            sink.addTriangles(window.data(), window.size());
+            total += window.size();
+        });
+        return total;
+    }
+
+private:
+    bool validGrid() const
+    {
+        if (sizeX < 2 || sizeY < 2 || sizeZ < 2)
+        {
+            std::cerr << "Error: Malla de muestreo no configurada correctamente." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    int threadCount() const
+    {
+        if (numThreads > 0)
+        {
+            return numThreads;
+        }
+#ifdef _OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    // Evalúa 'count' planos a partir del plano z en 'dest'
+    void samplePlanes(int z, int count, float *dest) const
+    {
+        for (int k = 0; k < count; k++)
+        {
+            const float fz = static_cast<float>(z + k);
+            for (int y = 0; y < sizeY; y++)
+            {
+                const float fy = static_cast<float>(y);
+                float *row = dest + (static_cast<size_t>(k) * sizeY + y) * sizeX;
+                for (int x = 0; x < sizeX; x++)
+                {
+                    row[x] = sampler(static_cast<float>(x), fy, fz);
+                }
+            }
+        }
+    }
+
+    // Procesa las capas de cubos en [zBegin, zEnd) por ventanas y llama a
+    // emit(triángulos) una vez por ventana
+    template <typename EmitFunc>
+    void extractSlab(int zBegin, int zEnd, EmitFunc emit) const
+    {
+        const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+        std::vector<float> window(planeSize * (slabDepth + 1));
+        std::vector<Triangle> triangles;
+
+        MarchingCubesSerial engine;
+        engine.setIsoValue(isoValue);
+
+        int planesInWindow = 0;
+
+        // La ventana cubre los planos [zBase, zBase + planesInWindow)
+        for (int zBase = zBegin; zBase < zEnd; zBase += slabDepth)
+        {
+            int wanted = std::min(slabDepth, zEnd - zBase) + 1;
+
+            if (planesInWindow == 0)
+            {
+                samplePlanes(zBase, wanted, window.data());
+            }
+            else
+            {
+                // El último plano de la ventana anterior es el primero de ésta
+                std::memcpy(window.data(), window.data() + planeSize * (planesInWindow - 1),
+                            planeSize * sizeof(float));
+                samplePlanes(zBase + 1, wanted - 1, window.data() + planeSize);
+            }
+            planesInWindow = wanted;
+
+            // Los vértices se generan directamente en coordenadas globales
+            engine.setScalarField(window.data(), sizeX, sizeY, planesInWindow);
+            engine.setOrigin(0, 0, zBase);
+            engine.generateIsosurface(triangles);
+            emit(triangles);
+        }
+    }
+
+    Sampler sampler;
+    int sizeX, sizeY, sizeZ;
+    int slabDepth;
+    float isoValue;
+    int numThreads;
+};
+
+#endif // MARCHING_CUBES_IMPLICIT_H
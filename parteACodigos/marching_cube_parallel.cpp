@@ -0,0 +1,362 @@
+#include "marching_cube_parallel.h"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Constructor
+MarchingCubesParallel::MarchingCubesParallel()
+    : numThreads(0), mode(ParallelMode::SLAB_BUFFERS), profiler(nullptr),
+      brickSize(32), brickIndex(nullptr)
+{
+}
+
+// Nombre de cada modo para informes
+const char *parallelModeName(ParallelMode mode)
+{
+    switch (mode)
+    {
+    case ParallelMode::SLAB_BUFFERS:
+        return "parallel-slabs";
+    case ParallelMode::COUNT_THEN_EMIT:
+        return "parallel-count-emit";
+    case ParallelMode::BRICK_TASKS:
+        return "parallel-bricks";
+    }
+    return "parallel";
+}
+
+// Configura los datos del volumen
+void MarchingCubesParallel::setScalarField(const float *data, int sx, int sy, int sz)
+{
+    engine.setScalarField(data, sx, sy, sz);
+}
+
+// Número de hilos que se usarán en la próxima ejecución
+int MarchingCubesParallel::getNumThreads() const
+{
+    if (numThreads > 0)
+    {
+        return numThreads;
+    }
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Número de slabs: uno por hilo, nunca más que capas de cubos
+int MarchingCubesParallel::numSlabs() const
+{
+    int numCubesZ = engine.getSizeZ() - 1;
+    return std::max(1, std::min(getNumThreads(), numCubesZ));
+}
+
+// Reparto estático y contiguo de capas: el slab es [zBegin, zEnd)
+void MarchingCubesParallel::slabRange(int slab, int slabs, int &zBegin, int &zEnd) const
+{
+    int numCubesZ = engine.getSizeZ() - 1;
+    zBegin = static_cast<int>(static_cast<long long>(numCubesZ) * slab / slabs);
+    zEnd = static_cast<int>(static_cast<long long>(numCubesZ) * (slab + 1) / slabs);
+}
+
+// Ejecuta el algoritmo y devuelve los triángulos generados
+std::vector<Triangle> MarchingCubesParallel::generateIsosurface()
+{
+    std::vector<Triangle> triangles;
+    generateIsosurface(triangles);
+    return triangles;
+}
+
+// Versión que devuelve el número de triángulos generados
+int MarchingCubesParallel::generateIsosurface(std::vector<Triangle> &triangles)
+{
+    triangles.clear();
+
+    if (!engine.hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    // Los bricks activos se calculan una vez, antes de repartir el trabajo
+    engine.prepareActiveBricks();
+
+    if (mode == ParallelMode::COUNT_THEN_EMIT)
+    {
+        return generateCountThenEmit(triangles);
+    }
+    if (mode == ParallelMode::BRICK_TASKS)
+    {
+        return generateBrickTasks(triangles);
+    }
+    return generateSlabBuffers(triangles);
+}
+
+// Modo SLAB_BUFFERS: un buffer por slab y fusión ordenada
+int MarchingCubesParallel::generateSlabBuffers(std::vector<Triangle> &triangles)
+{
+    int threads = numSlabs();
+
+    // Un buffer de triángulos por slab/hilo
+    std::vector<std::vector<Triangle>> buffers(threads);
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads)
+#endif
+    {
+#ifdef _OPENMP
+        int t = omp_get_thread_num();
+        int team = omp_get_num_threads();
+#else
+        int t = 0;
+        int team = 1;
+#endif
+        for (int slab = t; slab < threads; slab += team)
+        {
+            int zBegin, zEnd;
+            slabRange(slab, threads, zBegin, zEnd);
+            engine.generateIsosurfaceSlab(zBegin, zEnd, buffers[slab]);
+        }
+    }
+
+    // Fusión determinista: concatenar en orden de slab
+    ScopedPhase mergePhase(profiler, ExtractionPhase::MERGE);
+    size_t total = 0;
+    for (const auto &buffer : buffers)
+    {
+        total += buffer.size();
+    }
+    triangles.reserve(total);
+    for (const auto &buffer : buffers)
+    {
+        triangles.insert(triangles.end(), buffer.begin(), buffer.end());
+    }
+
+    return triangles.size();
+}
+
+// Modo COUNT_THEN_EMIT: conteo por fila, suma de prefijos y escritura directa
+int MarchingCubesParallel::generateCountThenEmit(std::vector<Triangle> &triangles)
+{
+    const int rowsY = engine.getSizeY() - 1;
+    const int rowsZ = engine.getSizeZ() - 1;
+    if (rowsY <= 0 || rowsZ <= 0 || engine.getSizeX() < 2)
+    {
+        return 0;
+    }
+    const long long numRows = static_cast<long long>(rowsY) * rowsZ;
+    const int threads = getNumThreads();
+
+    // Pasada 1: clasificar y contar triángulos por fila (y, z)
+    std::vector<size_t> offsets(numRows + 1, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(threads)
+#endif
+    for (long long row = 0; row < numRows; row++)
+    {
+        offsets[row + 1] = engine.countRowTriangles(static_cast<int>(row % rowsY),
+                                                    static_cast<int>(row / rowsY));
+    }
+
+    // Suma de prefijos: offsets[row] es la posición de la fila en la salida
+    for (long long row = 0; row < numRows; row++)
+    {
+        offsets[row + 1] += offsets[row];
+    }
+
+    // Pasada 2: cada fila escribe en su rango sin sincronización
+    triangles.resize(offsets[numRows]);
+    Triangle *out = triangles.data();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) num_threads(threads)
+#endif
+    for (long long row = 0; row < numRows; row++)
+    {
+        if (offsets[row + 1] != offsets[row])
+        {
+            engine.emitRowTriangles(static_cast<int>(row % rowsY),
+                                    static_cast<int>(row / rowsY),
+                                    out + offsets[row]);
+        }
+    }
+
+    return triangles.size();
+}
+
+// Modo BRICK_TASKS: bricks repartidos con robo de trabajo y fusión por brick
+int MarchingCubesParallel::generateBrickTasks(std::vector<Triangle> &triangles)
+{
+    const int cubesX = engine.getSizeX() - 1;
+    const int cubesY = engine.getSizeY() - 1;
+    const int cubesZ = engine.getSizeZ() - 1;
+    if (cubesX <= 0 || cubesY <= 0 || cubesZ <= 0)
+    {
+        return 0;
+    }
+
+    // Bricks a procesar: con un índice del mismo campo, solo los activos
+    std::vector<BrickIndex::Brick> bricks;
+    int side = brickSize;
+    if (brickIndex && !brickIndex->empty() && brickIndex->getSizeX() == engine.getSizeX() &&
+        brickIndex->getSizeY() == engine.getSizeY() && brickIndex->getSizeZ() == engine.getSizeZ())
+    {
+        side = brickIndex->getBrickSize();
+        brickIndex->collectActiveBricks(engine.getIsoValue(), bricks);
+        std::sort(bricks.begin(), bricks.end(), [](const BrickIndex::Brick &a, const BrickIndex::Brick &b) {
+            return a.bz != b.bz ? a.bz < b.bz : (a.by != b.by ? a.by < b.by : a.bx < b.bx);
+        });
+    }
+    else
+    {
+        for (int bz = 0; bz * side < cubesZ; bz++)
+        {
+            for (int by = 0; by * side < cubesY; by++)
+            {
+                for (int bx = 0; bx * side < cubesX; bx++)
+                {
+                    bricks.push_back({bx, by, bz});
+                }
+            }
+        }
+    }
+
+    const int threads = getNumThreads();
+    if (!pool || pool->numWorkers() != threads)
+    {
+        pool.reset(new WorkStealingPool(threads));
+    }
+
+    // Cada hilo añade a su buffer; se anota dónde quedó cada brick
+    const int numBricks = static_cast<int>(bricks.size());
+    std::vector<std::vector<Triangle>> buffers(threads);
+    std::vector<int> owner(numBricks);
+    std::vector<size_t> start(numBricks);
+    std::vector<size_t> offsets(numBricks + 1, 0);
+
+    pool->run(numBricks, [&](int worker, int task) {
+        const BrickIndex::Brick &b = bricks[task];
+        std::vector<Triangle> &buffer = buffers[worker];
+        owner[task] = worker;
+        start[task] = buffer.size();
+        offsets[task + 1] = engine.generateIsosurfaceBox(b.bx * side, b.by * side, b.bz * side,
+                                                         (b.bx + 1) * side, (b.by + 1) * side,
+                                                         (b.bz + 1) * side, buffer);
+    });
+    schedulerStats = pool->stats();
+
+    // Fusión determinista: suma de prefijos y copia de cada brick a su sitio
+    ScopedPhase mergePhase(profiler, ExtractionPhase::MERGE);
+    for (int task = 0; task < numBricks; task++)
+    {
+        offsets[task + 1] += offsets[task];
+    }
+    triangles.resize(offsets[numBricks]);
+    Triangle *out = triangles.data();
+
+    pool->run(numBricks, [&](int, int task) {
+        const Triangle *first = buffers[owner[task]].data() + start[task];
+        std::copy(first, first + (offsets[task + 1] - offsets[task]), out + offsets[task]);
+    });
+
+    return triangles.size();
+}
+
+// Entrega ordenada de bloques de capas a un MeshSink
+long long MarchingCubesParallel::generateIsosurface(MeshSink &sink)
+{
+    if (!engine.hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    engine.prepareActiveBricks();
+
+    // Bloques de pocas capas: más bloques que hilos para que la entrega
+    // ordenada no deje hilos esperando y el sink reciba datos pronto
+    const int numCubesZ = engine.getSizeZ() - 1;
+    const int threads = getNumThreads();
+    const int blocks = std::max(1, std::min(numCubesZ, threads * 8));
+    long long total = 0;
+
+#ifdef _OPENMP
+#pragma omp parallel num_threads(threads) reduction(+ : total)
+#endif
+    {
+        std::vector<Triangle> buffer;
+
+#ifdef _OPENMP
+#pragma omp for ordered schedule(static, 1)
+#endif
+        for (int block = 0; block < blocks; block++)
+        {
+            int zBegin, zEnd;
+            slabRange(block, blocks, zBegin, zEnd);
+            buffer.clear();
+            engine.generateIsosurfaceSlab(zBegin, zEnd, buffer);
+
+#ifdef _OPENMP
+#pragma omp ordered
+#endif
+            {
+                sink.addTriangles(buffer.data(), buffer.size());
+            }
+            total += buffer.size();
+        }
+    }
+
+    return total;
+}
+
+// Una malla por isovalor en un único recorrido, repartido por slabs
+int MarchingCubesParallel::generateIsosurfaces(const std::vector<float> &isoValues,
+                                               std::vector<std::vector<Triangle>> &meshes)
+{
+    meshes.assign(isoValues.size(), std::vector<Triangle>());
+
+    if (!engine.hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    int threads = numSlabs();
+
+    // buffers[slab][k]: triángulos del isovalor k generados en el slab
+    std::vector<std::vector<std::vector<Triangle>>> buffers(threads);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(threads)
+#endif
+    for (int slab = 0; slab < threads; slab++)
+    {
+        int zBegin, zEnd;
+        slabRange(slab, threads, zBegin, zEnd);
+        engine.generateIsosurfacesSlab(zBegin, zEnd, isoValues, buffers[slab]);
+    }
+
+    // Fusión determinista por isovalor, en orden de slab
+    size_t total = 0;
+    for (size_t k = 0; k < isoValues.size(); k++)
+    {
+        size_t count = 0;
+        for (const auto &buffer : buffers)
+        {
+            count += buffer[k].size();
+        }
+        meshes[k].reserve(count);
+        for (const auto &buffer : buffers)
+        {
+            meshes[k].insert(meshes[k].end(), buffer[k].begin(), buffer[k].end());
+        }
+        total += count;
+    }
+
+    return total;
+}
@@ -0,0 +1,128 @@
+#ifndef MARCHING_CUBES_PARALLEL_H
+#define MARCHING_CUBES_PARALLEL_H
+
+#include <memory>
+#include <vector>
+#include "marching_cube_serial.h"
+#include "mesh_sink.h"
+#include "perf_counters.h"
+#include "work_stealing_pool.h"
+
+// Estrategias de generación de la salida
+enum class ParallelMode
+{
+    // Un buffer por hilo/slab que se concatena al final
+    SLAB_BUFFERS,
+    // Dos pasadas: contar triángulos por fila, suma de prefijos y escritura
+    // directa en un buffer preasignado (sin fusión ni realocaciones)
+    COUNT_THEN_EMIT,
+    // Bricks de brickSize^3 cubos repartidos en un grupo de hilos con robo
+    // de trabajo; un buffer por hilo y fusión en orden de brick
+    BRICK_TASKS
+};
+
+// Nombre de cada modo para informes
+const char *parallelModeName(ParallelMode mode);
+
+// Versión paralela (OpenMP) del algoritmo Marching Cubes.
+// En modo SLAB_BUFFERS divide el bucle en z en bloques contiguos (slabs), uno
+// por hilo; cada hilo acumula sus triángulos en un buffer propio y al final se
+// concatenan en el orden de los slabs. En modo COUNT_THEN_EMIT cada fila
+// conoce de antemano su posición en la salida. En ambos casos el resultado es
+// idéntico al de la versión serial. En modo BRICK_TASKS el volumen se divide
+// en bricks que los hilos se reparten dinámicamente (el reparto estático por
+// slabs se desequilibra cuando la superficie se concentra en pocas capas);
+// se generan los mismos triángulos, agrupados por brick.
+class MarchingCubesParallel
+{
+private:
+    // Motor serial reutilizado para procesar cada slab
+    MarchingCubesSerial engine;
+
+    // Número de hilos a usar (0 = valor por defecto de OpenMP)
+    int numThreads;
+
+    // Estrategia de generación de la salida
+    ParallelMode mode;
+
+    // Perfilador opcional de la fase de fusión (no es propiedad de la clase)
+    PhaseProfiler *profiler;
+
+    // Modo BRICK_TASKS: lado de los bricks, índice min/max para planificar
+    // solo los bricks activos (no es propiedad de la clase) y grupo de hilos,
+    // que se crea en la primera ejecución y se conserva entre ejecuciones
+    int brickSize;
+    const BrickIndex *brickIndex;
+    std::unique_ptr<WorkStealingPool> pool;
+    std::vector<WorkStealingPool::WorkerStats> schedulerStats;
+
+    // Número de slabs (uno por hilo, nunca más que capas de cubos)
+    int numSlabs() const;
+
+    // Capas z del slab 'slab' de 'slabs': [zBegin, zEnd)
+    void slabRange(int slab, int slabs, int &zBegin, int &zEnd) const;
+
+    // Implementaciones de cada modo
+    int generateSlabBuffers(std::vector<Triangle> &triangles);
+    int generateCountThenEmit(std::vector<Triangle> &triangles);
+    int generateBrickTasks(std::vector<Triangle> &triangles);
+
+public:
+    // Constructor
+    MarchingCubesParallel();
+
+    // Configura los datos del volumen
+    void setScalarField(const float *data, int sx, int sy, int sz);
+
+    // Establece el isovalor
+    void setIsoValue(float value) { engine.setIsoValue(value); }
+
+    // Asocia una jerarquía min/max para saltar el espacio vacío. En modo
+    // BRICK_TASKS sus bricks sustituyen a los de setBrickSize
+    void setBrickIndex(const BrickIndex *index)
+    {
+        brickIndex = index;
+        engine.setBrickIndex(index);
+    }
+
+    // Lado en cubos de los bricks del modo BRICK_TASKS (32 por defecto)
+    void setBrickSize(int size) { brickSize = size > 0 ? size : 32; }
+    int getBrickSize() const { return brickSize; }
+
+    // Tareas, robos y tiempo ocupado de cada hilo en la última ejecución en
+    // modo BRICK_TASKS (sin contar la fusión)
+    const std::vector<WorkStealingPool::WorkerStats> &getSchedulerStats() const { return schedulerStats; }
+
+    // Establece el número de hilos (0 = valor por defecto de OpenMP)
+    void setNumThreads(int threads) { numThreads = threads; }
+
+    // Número de hilos que se usarán en la próxima ejecución
+    int getNumThreads() const;
+
+    // Selecciona la estrategia de generación de la salida
+    void setMode(ParallelMode m) { mode = m; }
+    ParallelMode getMode() const { return mode; }
+
+    // Registra en 'p' la fase de fusión de buffers (modo SLAB_BUFFERS); la
+    // fusión corre en el hilo que llama, que es el que 'p' mide
+    void setProfiler(PhaseProfiler *p) { profiler = p; }
+
+    // Ejecuta el algoritmo y devuelve los triángulos generados
+    std::vector<Triangle> generateIsosurface();
+
+    // Versión que devuelve el número de triángulos generados
+    int generateIsosurface(std::vector<Triangle> &triangles);
+
+    // Entrega los triángulos a 'sink' mientras se generan. El volumen se
+    // divide en bloques de pocas capas; cada hilo genera sus bloques en
+    // paralelo y los entrega en orden, de modo que la salida es idéntica a la
+    // serial y la escritura se solapa con el cálculo
+    long long generateIsosurface(MeshSink &sink);
+
+    // Una malla por isovalor en un único recorrido del volumen (por slabs,
+    // con fusión ordenada). Devuelve el total de triángulos
+    int generateIsosurfaces(const std::vector<float> &isoValues,
+                            std::vector<std::vector<Triangle>> &meshes);
+};
+
+#endif // MARCHING_CUBES_PARALLEL_H
@@ -1,101 +1,148 @@
 #include "marching_cube_serial.h"
+#include "cube_classifier.h"
+#include "mesh_sink.h"
+#include "perf_counters.h"
+#include "src/metrics.h"
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include <iostream>
 
-// Tabla de aristas: indica qué aristas están cortadas por la isosuperficie
-const int MarchingCubesSerial::edgeTable[256] = {
-    0x0, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
-    0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
-    0x190, 0x99, 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
-    0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
-    0x230, 0x339, 0x33, 0x13a, 0x636, 0x73f, 0x435, 0x53c,
-    0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
-    0x3a0, 0x2a9, 0x1a3, 0xaa, 0x7a6, 0x6af, 0x5a5, 0x4ac,
-    0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
-    0x460, 0x569, 0x663, 0x76a, 0x66, 0x16f, 0x265, 0x36c,
-    0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
-    0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff, 0x3f5, 0x2fc,
-    0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
-    0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55, 0x15c,
-    0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
-    0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc,
-    0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
-    0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
-    0xcc, 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
-    0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
-    0x15c, 0x55, 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
-    0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
-    0x2fc, 0x3f5, 0xff, 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
-    0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
-    0x36c, 0x265, 0x16f, 0x66, 0x76a, 0x663, 0x569, 0x460,
-    0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
-    0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa, 0x1a3, 0x2a9, 0x3a0,
-    0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
-    0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33, 0x339, 0x230,
-    0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
-    0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99, 0x190,
-    0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
-    0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0};
-
-// Tabla de triangulación (versión simplificada para brevedad)
-// En una implementación real, esta tabla sería mucho más extensa
-const int MarchingCubesSerial::triTable[256][16] = {
-    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-    {0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-    {0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-    {1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
-    // ... resto de las configuraciones ...
-    // Esta tabla completa tiene 256 entradas
-};
-
-// Offsets de vértices para un cubo
-const int MarchingCubesSerial::vertexOffsets[8][3] = {
-    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
-
-// Definición de las aristas del cubo
-const int MarchingCubesSerial::edgeVertices[12][2] = {
-    {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
-
 // Constructor
-MarchingCubesSerial::MarchingCubesSerial()
-    : scalarField(nullptr), sizeX(0), sizeY(0), sizeZ(0), isoValue(0.0f)
+template <typename T>
+MarchingCubesSerialT<T>::MarchingCubesSerialT()
+    : scalarField(nullptr), sizeX(0), sizeY(0), sizeZ(0), isoValue(0.0f),
+      valueScale(1.0f), valueOffset(0.0f), storedIso(),
+      originX(0), originY(0), originZ(0), computeNormals(false),
+      brickIndex(nullptr), activeBricksReady(false), activeBricksIso(0.0f)
 {
+    updateStoredIso();
 }
 
 // Destructor
-MarchingCubesSerial::~MarchingCubesSerial()
+template <typename T>
+MarchingCubesSerialT<T>::~MarchingCubesSerialT()
 {
     // No necesitamos liberar scalarField ya que no es propiedad de esta clase
 }
 
 // Configura los datos del volumen
-void MarchingCubesSerial::setScalarField(float *data, int sx, int sy, int sz)
+template <typename T>
+void MarchingCubesSerialT<T>::setScalarField(const T *data, int sx, int sy, int sz)
 {
     scalarField = data;
     sizeX = sx;
     sizeY = sy;
     sizeZ = sz;
+    activeBricksReady = false;
+
+    const ptrdiff_t planeSize = static_cast<ptrdiff_t>(sx) * sy;
+    for (int i = 0; i < 8; i++)
+    {
+        cornerOffsets[i] = vertexOffsets[i][2] * planeSize + vertexOffsets[i][1] * sx + vertexOffsets[i][0];
+    }
+}
+
+// Correspondencia entre valor almacenado y valor real
+template <typename T>
+void MarchingCubesSerialT<T>::setValueMapping(float scale, float offset)
+{
+    if (!(scale > 0.0f))
+    {
+        std::cerr << "Error: la escala de los valores debe ser positiva." << std::endl;
+        return;
+    }
+    valueScale = scale;
+    valueOffset = offset;
+    updateStoredIso();
+}
+
+// Asocia la jerarquía min/max del campo
+template <typename T>
+void MarchingCubesSerialT<T>::setBrickIndex(const BrickIndex *index)
+{
+    brickIndex = index;
+    activeBricksReady = false;
+}
+
+// Calcula los bricks activos para el isovalor actual
+template <typename T>
+void MarchingCubesSerialT<T>::prepareActiveBricks()
+{
+    if (!brickIndex || (activeBricksReady && activeBricksIso == isoValue))
+    {
+        return;
+    }
+
+    if (brickIndex->empty() || brickIndex->getSizeX() != sizeX ||
+        brickIndex->getSizeY() != sizeY || brickIndex->getSizeZ() != sizeZ)
+    {
+        std::cerr << "Aviso: el índice de bricks no corresponde al campo; se ignora." << std::endl;
+        activeBricksReady = false;
+        return;
+    }
+
+    std::vector<BrickIndex::Brick> bricks;
+    brickIndex->collectActiveBricks(isoValue, bricks);
+
+    const int bricksY = brickIndex->bricksY();
+    activeBrickRows.assign(static_cast<size_t>(bricksY) * brickIndex->bricksZ(), std::vector<int>());
+    for (const BrickIndex::Brick &b : bricks)
+    {
+        activeBrickRows[static_cast<size_t>(b.bz) * bricksY + b.by].push_back(b.bx);
+    }
+
+    // Recorrer los tramos en x creciente conserva el orden del recorrido completo
+    for (std::vector<int> &row : activeBrickRows)
+    {
+        std::sort(row.begin(), row.end());
+    }
+
+    activeBricksIso = isoValue;
+    activeBricksReady = true;
 }
 
 // Obtiene el valor escalar en una posición del grid
-float MarchingCubesSerial::getScalarValue(int x, int y, int z) const
+template <typename T>
+float MarchingCubesSerialT<T>::getScalarValue(int x, int y, int z) const
 {
     if (x < 0 || x >= sizeX || y < 0 || y >= sizeY || z < 0 || z >= sizeZ)
     {
         return 0.0f;
     }
-    return scalarField[z * sizeX * sizeY + y * sizeX + x];
+    return decode(scalarField[(static_cast<size_t>(z) * sizeY + y) * sizeX + x]);
+}
+
+// Clave del vóxel almacenado; fuera del grid, la del valor almacenado 0
+template <typename T>
+typename MarchingCubesSerialT<T>::Key MarchingCubesSerialT<T>::getStoredKey(int x, int y, int z) const
+{
+    if (x < 0 || x >= sizeX || y < 0 || y >= sizeY || z < 0 || z >= sizeZ)
+    {
+        return ScalarTraits<T>::key(T());
+    }
+    return ScalarTraits<T>::key(scalarField[(static_cast<size_t>(z) * sizeY + y) * sizeX + x]);
 }
 
 // Interpola entre dos vértices basándose en el isovalor
-Vertex MarchingCubesSerial::interpolateVertex(const Vertex &v1, float val1,
+template <typename T>
+Vertex MarchingCubesSerialT<T>::interpolateVertex(const Vertex &v1, float val1,
                                               const Vertex &v2, float val2) const
 {
-    if (std::abs(isoValue - val1) < 0.00001f)
+    return interpolateVertex(v1, val1, v2, val2, isoValue);
+}
+
+// Interpola entre dos vértices para un isovalor dado
+template <typename T>
+Vertex MarchingCubesSerialT<T>::interpolateVertex(const Vertex &v1, float val1,
+                                              const Vertex &v2, float val2, float iso)
+{
+    if (std::abs(iso - val1) < 0.00001f)
     {
         return v1;
     }
-    if (std::abs(isoValue - val2) < 0.00001f)
+    if (std::abs(iso - val2) < 0.00001f)
     {
         return v2;
     }
@@ -104,42 +151,218 @@ Vertex MarchingCubesSerial::interpolateVertex(const Vertex &v1, float val1,
         return v1;
     }
 
-    float t = (isoValue - val1) / (val2 - val1);
+    float t = (iso - val1) / (val2 - val1);
     return v1 + (v2 - v1) * t;
 }
 
-// Procesa un cubo individual
-void MarchingCubesSerial::processCube(int x, int y, int z, std::vector<Triangle> &triangles)
+// Peso del punto de corte con los mismos casos límite que interpolateVertex
+template <typename T>
+float MarchingCubesSerialT<T>::interpolationWeight(float val1, float val2, float iso)
 {
-    // Obtener los valores escalares en los 8 vértices del cubo
-    float cubeValues[8];
-    for (int i = 0; i < 8; i++)
+    if (std::abs(iso - val1) < 0.00001f)
     {
-        cubeValues[i] = getScalarValue(
-            x + vertexOffsets[i][0],
-            y + vertexOffsets[i][1],
-            z + vertexOffsets[i][2]);
+        return 0.0f;
     }
+    if (std::abs(iso - val2) < 0.00001f)
+    {
+        return 1.0f;
+    }
+    if (std::abs(val1 - val2) < 0.00001f)
+    {
+        return 0.0f;
+    }
+    return (iso - val1) / (val2 - val1);
+}
+
+// Interpola posición y gradiente. La normal apunta hacia los valores bajo el
+// isovalor, que es el lado hacia el que miran los triángulos de las tablas
+template <typename T>
+Vertex MarchingCubesSerialT<T>::interpolateVertex(const Vertex &v1, float val1, const Vertex &g1,
+                                              const Vertex &v2, float val2, const Vertex &g2,
+                                              Vertex &normal) const
+{
+    float t = interpolationWeight(val1, val2, isoValue);
+    Vertex gradient = g1 + (g2 - g1) * t;
+    float length = std::sqrt(gradient.x * gradient.x + gradient.y * gradient.y + gradient.z * gradient.z);
+    normal = length > 0.0f ? gradient * (-1.0f / length) : Vertex();
+    return interpolateVertex(v1, val1, v2, val2);
+}
 
-    // Determinar el índice de configuración del cubo
+// Gradiente por diferencias centradas (laterales en los bordes)
+template <typename T>
+Vertex MarchingCubesSerialT<T>::gradientAt(int x, int y, int z) const
+{
+    const T *voxel = scalarField + (static_cast<size_t>(z) * sizeY + y) * sizeX + x;
+    auto derivative = [&](int i, int size, ptrdiff_t stride) {
+        int before = i > 0 ? 1 : 0;
+        int after = i < size - 1 ? 1 : 0;
+        if (before + after == 0)
+        {
+            return 0.0f;
+        }
+        return (decode(voxel[after * stride]) - decode(voxel[-before * stride])) / (before + after);
+    };
+    return Vertex(derivative(x, sizeX, 1),
+                  derivative(y, sizeY, sizeX),
+                  derivative(z, sizeZ, static_cast<ptrdiff_t>(sizeX) * sizeY));
+}
+
+// Índice de configuración del cubo con esquina inferior (x, y, z)
+template <typename T>
+int MarchingCubesSerialT<T>::getCubeIndex(int x, int y, int z) const
+{
     int cubeIndex = 0;
     for (int i = 0; i < 8; i++)
     {
-        if (cubeValues[i] < isoValue)
+        if (getStoredKey(x + vertexOffsets[i][0],
+                         y + vertexOffsets[i][1],
+                         z + vertexOffsets[i][2]) < storedIso)
         {
             cubeIndex |= (1 << i);
         }
     }
+    return cubeIndex;
+}
+
+// Buffer de índices de configuración de una fila, propio de cada hilo
+static unsigned char *rowCaseBuffer(int numCubes)
+{
+    thread_local std::vector<unsigned char> buffer;
+    if (buffer.size() < static_cast<size_t>(numCubes))
+    {
+        buffer.resize(numCubes);
+    }
+    return buffer.data();
+}
 
+// Clasifica de una vez todos los cubos de la fila (y, z)
+template <typename T>
+void MarchingCubesSerialT<T>::classifyRow(int y, int z, unsigned char *cases) const
+{
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+    const T *row00 = scalarField + z * planeSize + static_cast<size_t>(y) * sizeX;
+    const T *row10 = row00 + sizeX;
+    const T *row01 = row00 + planeSize;
+    const T *row11 = row01 + sizeX;
+    classifyCubeRow(row00, row10, row01, row11, sizeX - 1, storedIso, cases);
+}
+
+// Clasifica la fila (y, z) y visita los cubos que generan triángulos
+template <typename T>
+template <typename CubeFunc>
+void MarchingCubesSerialT<T>::forEachActiveCube(int y, int z, unsigned char *cases, CubeFunc fn) const
+{
+    if (!usesBricks())
+    {
+        classifyRow(y, z, cases);
+        int activeCells = 0;
+        for (int x = 0; x < sizeX - 1; x++)
+        {
+            if (triangleCounts[cases[x]])
+            {
+                fn(x, cases[x]);
+                activeCells++;
+            }
+        }
+        MC_METRIC_ADD(CELLS_VISITED, sizeX - 1);
+        MC_METRIC_ADD(ACTIVE_CELLS, activeCells);
+        return;
+    }
+
+    // Solo los tramos de la fila que caen en bricks activos
+    const int brickSize = brickIndex->getBrickSize();
+    const std::vector<int> &bricks =
+        activeBrickRows[static_cast<size_t>(z / brickSize) * brickIndex->bricksY() + y / brickSize];
+    if (bricks.empty())
+    {
+        return;
+    }
+
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+    const T *row00 = scalarField + z * planeSize + static_cast<size_t>(y) * sizeX;
+    const T *row10 = row00 + sizeX;
+    const T *row01 = row00 + planeSize;
+    const T *row11 = row01 + sizeX;
+
+    int visitedCells = 0;
+    int activeCells = 0;
+    for (int bx : bricks)
+    {
+        int x0 = bx * brickSize;
+        int x1 = std::min(x0 + brickSize, sizeX - 1);
+        classifyCubeRow(row00 + x0, row10 + x0, row01 + x0, row11 + x0, x1 - x0, storedIso, cases + x0);
+        visitedCells += x1 - x0;
+        for (int x = x0; x < x1; x++)
+        {
+            if (triangleCounts[cases[x]])
+            {
+                fn(x, cases[x]);
+                activeCells++;
+            }
+        }
+    }
+    MC_METRIC_ADD(CELLS_VISITED, visitedCells);
+    MC_METRIC_ADD(ACTIVE_CELLS, activeCells);
+}
+
+// Triangula un cubo individual escribiendo los triángulos en 'out'
+template <typename T>
+int MarchingCubesSerialT<T>::polygonizeCube(int x, int y, int z, Triangle *out) const
+{
+    if (x >= 0 && y >= 0 && z >= 0 && x < sizeX - 1 && y < sizeY - 1 && z < sizeZ - 1)
+    {
+        return polygonizeCube(x, y, z, interiorCubeIndex(x, y, z), out);
+    }
+
+    // Cubo del borde o exterior: las esquinas fuera del grid valen 0
+    int cubeIndex = getCubeIndex(x, y, z);
+    if (!triangleCounts[cubeIndex])
+    {
+        return 0;
+    }
+    float cubeValues[8];
+    for (int i = 0; i < 8; i++)
+    {
+        cubeValues[i] = getScalarValue(x + vertexOffsets[i][0],
+                                       y + vertexOffsets[i][1],
+                                       z + vertexOffsets[i][2]);
+    }
+    return polygonizeCube(x, y, z, cubeIndex, cubeValues, isoValue, out);
+}
+
+// Triangula un cubo cuyo índice de configuración ya es conocido
+template <typename T>
+int MarchingCubesSerialT<T>::polygonizeCube(int x, int y, int z, int cubeIndex, Triangle *out) const
+{
     // Si el cubo está completamente dentro o fuera, no hay triángulos
     if (edgeTable[cubeIndex] == 0)
     {
-        return;
+        return 0;
     }
 
-    // Encontrar los vértices donde la superficie intersecta las aristas
+    // Obtener los valores escalares en los 8 vértices del cubo
+    float cubeValues[8];
+    loadCorners(x, y, z, cubeValues);
+
+    return polygonizeCube(x, y, z, cubeIndex, cubeValues, isoValue, out);
+}
+
+// Triangula un cubo a partir de los valores de sus esquinas ya cargados
+template <typename T>
+int MarchingCubesSerialT<T>::polygonizeCube(int x, int y, int z, int cubeIndex,
+                                        const float cubeValues[8], float iso, Triangle *out) const
+{
     Vertex vertList[12];
+    interpolateEdges(x, y, z, cubeIndex, cubeValues, iso, vertList);
+    return assembleTriangles(cubeIndex, vertList, out);
+}
 
+// Calcula los vértices donde la superficie intersecta las aristas cortadas
+template <typename T>
+void MarchingCubesSerialT<T>::interpolateEdges(int x, int y, int z, int cubeIndex,
+                                           const float cubeValues[8], float iso,
+                                           Vertex vertList[12]) const
+{
     // Verificar cada arista
     for (int i = 0; i < 12; i++)
     {
@@ -149,32 +372,75 @@ void MarchingCubesSerial::processCube(int x, int y, int z, std::vector<Triangle>
             int v1 = edgeVertices[i][1];
 
             Vertex p0(
-                x + vertexOffsets[v0][0],
-                y + vertexOffsets[v0][1],
-                z + vertexOffsets[v0][2]);
+                originX + x + vertexOffsets[v0][0],
+                originY + y + vertexOffsets[v0][1],
+                originZ + z + vertexOffsets[v0][2]);
 
             Vertex p1(
-                x + vertexOffsets[v1][0],
-                y + vertexOffsets[v1][1],
-                z + vertexOffsets[v1][2]);
+                originX + x + vertexOffsets[v1][0],
+                originY + y + vertexOffsets[v1][1],
+                originZ + z + vertexOffsets[v1][2]);
 
-            vertList[i] = interpolateVertex(p0, cubeValues[v0], p1, cubeValues[v1]);
+            vertList[i] = interpolateVertex(p0, cubeValues[v0], p1, cubeValues[v1], iso);
         }
     }
+}
 
-    // Crear los triángulos según la tabla de triangulación
-    for (int i = 0; triTable[cubeIndex][i] != -1; i += 3)
+// Crea los triángulos según la tabla de triangulación
+template <typename T>
+int MarchingCubesSerialT<T>::assembleTriangles(int cubeIndex, const Vertex vertList[12], Triangle *out)
+{
+    // Las aristas de cada triángulo van empaquetadas de 4 en 4 bits
+    uint64_t edges = triangleTable[cubeIndex];
+    int count = triangleCounts[cubeIndex];
+    for (int t = 0; t < count; t++, edges >>= 12)
     {
-        Triangle tri(
-            vertList[triTable[cubeIndex][i]],
-            vertList[triTable[cubeIndex][i + 1]],
-            vertList[triTable[cubeIndex][i + 2]]);
-        triangles.push_back(tri);
+        out[t] = Triangle(
+            vertList[edges & 0xF],
+            vertList[(edges >> 4) & 0xF],
+            vertList[(edges >> 8) & 0xF]);
     }
+    return count;
+}
+
+// Procesa un cubo individual
+template <typename T>
+void MarchingCubesSerialT<T>::processCube(int x, int y, int z, std::vector<Triangle> &triangles) const
+{
+    Triangle cubeTriangles[5];
+    int count = polygonizeCube(x, y, z, cubeTriangles);
+    triangles.insert(triangles.end(), cubeTriangles, cubeTriangles + count);
+}
+
+// Cuenta los triángulos que generaría la fila de cubos (y, z)
+template <typename T>
+int MarchingCubesSerialT<T>::countRowTriangles(int y, int z) const
+{
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+
+    int count = 0;
+    forEachActiveCube(y, z, cases, [&](int, int cubeIndex) {
+        count += triangleCounts[cubeIndex];
+    });
+    return count;
+}
+
+// Escribe en 'out' los triángulos de la fila de cubos (y, z)
+template <typename T>
+int MarchingCubesSerialT<T>::emitRowTriangles(int y, int z, Triangle *out) const
+{
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+
+    int count = 0;
+    forEachActiveCube(y, z, cases, [&](int x, int cubeIndex) {
+        count += polygonizeCube(x, y, z, cubeIndex, out + count);
+    });
+    return count;
 }
 
 // Ejecuta el algoritmo y devuelve los triángulos generados
-std::vector<Triangle> MarchingCubesSerial::generateIsosurface()
+template <typename T>
+std::vector<Triangle> MarchingCubesSerialT<T>::generateIsosurface()
 {
     std::vector<Triangle> triangles;
     generateIsosurface(triangles);
@@ -182,27 +448,537 @@ std::vector<Triangle> MarchingCubesSerial::generateIsosurface()
 }
 
 // Versión que devuelve el número de triángulos generados
-int MarchingCubesSerial::generateIsosurface(std::vector<Triangle> &triangles)
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurface(std::vector<Triangle> &triangles)
 {
     triangles.clear();
 
-    if (!scalarField || sizeX <= 0 || sizeY <= 0 || sizeZ <= 0)
+    if (!hasScalarField())
     {
         std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
         return 0;
     }
 
     // Procesar cada cubo en el volumen
-    for (int z = 0; z < sizeZ - 1; z++)
+    prepareActiveBricks();
+    generateIsosurfaceSlab(0, sizeZ - 1, triangles);
+
+    return triangles.size();
+}
+
+// Procesa los cubos de las capas z en [zBegin, zEnd)
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurfaceSlab(int zBegin, int zEnd, std::vector<Triangle> &triangles) const
+{
+    MC_SCOPED_TIMER("mc_extract_slab");
+    size_t before = triangles.size();
+
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, sizeZ - 1);
+
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+    Triangle cubeTriangles[5];
+
+    for (int z = zBegin; z < zEnd; z++)
     {
         for (int y = 0; y < sizeY - 1; y++)
         {
-            for (int x = 0; x < sizeX - 1; x++)
+            // Clasificar la fila completa y triangular solo los cubos activos
+            forEachActiveCube(y, z, cases, [&](int x, int cubeIndex) {
+                int count = polygonizeCube(x, y, z, cubeIndex, cubeTriangles);
+                triangles.insert(triangles.end(), cubeTriangles, cubeTriangles + count);
+            });
+        }
+    }
+
+    MC_METRIC_ADD(TRIANGLES_EMITTED, triangles.size() - before);
+    return triangles.size() - before;
+}
+
+// Procesa los cubos de la caja [x0, x1) x [y0, y1) x [z0, z1)
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurfaceBox(int x0, int y0, int z0, int x1, int y1, int z1,
+                                                   std::vector<Triangle> &triangles) const
+{
+    MC_SCOPED_TIMER("mc_extract_box");
+    size_t before = triangles.size();
+
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    z0 = std::max(z0, 0);
+    x1 = std::min(x1, sizeX - 1);
+    y1 = std::min(y1, sizeY - 1);
+    z1 = std::min(z1, sizeZ - 1);
+    if (x0 >= x1 || y0 >= y1 || z0 >= z1)
+    {
+        return 0;
+    }
+
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+    unsigned char *cases = rowCaseBuffer(x1 - x0);
+    Triangle cubeTriangles[5];
+    int activeCells = 0;
+
+    for (int z = z0; z < z1; z++)
+    {
+        for (int y = y0; y < y1; y++)
+        {
+            const T *row00 = scalarField + z * planeSize + static_cast<size_t>(y) * sizeX + x0;
+            const T *row10 = row00 + sizeX;
+            const T *row01 = row00 + planeSize;
+            const T *row11 = row01 + sizeX;
+            classifyCubeRow(row00, row10, row01, row11, x1 - x0, storedIso, cases);
+
+            for (int x = x0; x < x1; x++)
             {
-                processCube(x, y, z, triangles);
+                int cubeIndex = cases[x - x0];
+                if (triangleCounts[cubeIndex])
+                {
+                    int count = polygonizeCube(x, y, z, cubeIndex, cubeTriangles);
+                    triangles.insert(triangles.end(), cubeTriangles, cubeTriangles + count);
+                    activeCells++;
+                }
             }
         }
     }
 
+    MC_METRIC_ADD(CELLS_VISITED, static_cast<long long>(x1 - x0) * (y1 - y0) * (z1 - z0));
+    MC_METRIC_ADD(ACTIVE_CELLS, activeCells);
+    MC_METRIC_ADD(TRIANGLES_EMITTED, triangles.size() - before);
+    return triangles.size() - before;
+}
+
+// Versión instrumentada: cada capa z se procesa en tres fases separadas
+// (clasificar todas sus filas, interpolar las aristas de los cubos activos y
+// ensamblar los triángulos) para atribuir tiempo y contadores a cada una
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurfaceProfiled(std::vector<Triangle> &triangles,
+                                                    PhaseProfiler &profiler)
+{
+    triangles.clear();
+
+    if (!hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    prepareActiveBricks();
+
+    // Cubos activos de la capa y sus 12 posibles cruces
+    struct ActiveCube
+    {
+        int x, y, cubeIndex;
+    };
+    std::vector<ActiveCube> active;
+    std::vector<Vertex> crossings;
+
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+    float cubeValues[8];
+    Triangle cubeTriangles[5];
+
+    for (int z = 0; z < sizeZ - 1; z++)
+    {
+        profiler.begin(ExtractionPhase::CLASSIFICATION);
+        active.clear();
+        for (int y = 0; y < sizeY - 1; y++)
+        {
+            forEachActiveCube(y, z, cases, [&](int x, int cubeIndex) {
+                active.push_back({x, y, cubeIndex});
+            });
+        }
+
+        profiler.begin(ExtractionPhase::INTERPOLATION);
+        crossings.assign(active.size() * 12, Vertex());
+        for (size_t c = 0; c < active.size(); c++)
+        {
+            const ActiveCube &cube = active[c];
+            loadCorners(cube.x, cube.y, z, cubeValues);
+            interpolateEdges(cube.x, cube.y, z, cube.cubeIndex, cubeValues, isoValue,
+                             &crossings[c * 12]);
+        }
+
+        profiler.begin(ExtractionPhase::EMISSION);
+        for (size_t c = 0; c < active.size(); c++)
+        {
+            int count = assembleTriangles(active[c].cubeIndex, &crossings[c * 12], cubeTriangles);
+            triangles.insert(triangles.end(), cubeTriangles, cubeTriangles + count);
+        }
+        profiler.end();
+    }
+
     return triangles.size();
-}
\ No newline at end of file
+}
+
+// Entrega los triángulos a un MeshSink a medida que se generan
+template <typename T>
+long long MarchingCubesSerialT<T>::generateIsosurface(MeshSink &sink)
+{
+    if (!hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    prepareActiveBricks();
+    return generateIsosurfaceSlab(0, sizeZ - 1, sink);
+}
+
+// Versión con MeshSink de las capas z en [zBegin, zEnd)
+template <typename T>
+long long MarchingCubesSerialT<T>::generateIsosurfaceSlab(int zBegin, int zEnd, MeshSink &sink) const
+{
+    MC_SCOPED_TIMER("mc_extract_slab");
+
+    // Bloque local que se entrega al sink cuando se llena
+    const size_t chunkSize = 4096;
+    std::vector<Triangle> chunk(chunkSize);
+    size_t used = 0;
+    long long total = 0;
+
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, sizeZ - 1);
+
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+
+    for (int z = zBegin; z < zEnd; z++)
+    {
+        for (int y = 0; y < sizeY - 1; y++)
+        {
+            forEachActiveCube(y, z, cases, [&](int x, int cubeIndex) {
+                if (used + 5 > chunkSize)
+                {
+                    sink.addTriangles(chunk.data(), used);
+                    total += used;
+                    used = 0;
+                }
+                used += polygonizeCube(x, y, z, cubeIndex, chunk.data() + used);
+            });
+        }
+    }
+
+    if (used > 0)
+    {
+        sink.addTriangles(chunk.data(), used);
+        total += used;
+    }
+    MC_METRIC_ADD(TRIANGLES_EMITTED, total);
+    return total;
+}
+
+// Genera una malla indexada reutilizando los cruces de aristas compartidas
+template <typename T>
+int MarchingCubesSerialT<T>::generateIndexedMesh(IndexedMesh &mesh)
+{
+    MC_SCOPED_TIMER("mc_indexed_mesh");
+    mesh.clear();
+
+    if (!hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    const uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+
+    // Caché de índices de vértice por arista:
+    // - aristas x e y de los planos z (índice 0) y z+1 (índice 1)
+    // - aristas z entre ambos planos
+    std::vector<uint32_t> xEdges[2], yEdges[2];
+    std::vector<uint32_t> zEdges(planeSize, noVertex);
+    for (int p = 0; p < 2; p++)
+    {
+        xEdges[p].assign(planeSize, noVertex);
+        yEdges[p].assign(planeSize, noVertex);
+    }
+
+    // Gradientes de los vóxeles de los planos z (0) y z+1 (1), calculados
+    // la primera vez que los pide una esquina de un cubo activo
+    std::vector<Vertex> gradients[2];
+    std::vector<unsigned char> gradientReady[2];
+    if (computeNormals)
+    {
+        for (int p = 0; p < 2; p++)
+        {
+            gradients[p].resize(planeSize);
+            gradientReady[p].assign(planeSize, 0);
+        }
+    }
+
+    unsigned char *cases = rowCaseBuffer(sizeX - 1);
+    prepareActiveBricks();
+
+    for (int z = 0; z < sizeZ - 1; z++)
+    {
+        auto cornerGradient = [&](int corner, int x, int y) -> const Vertex & {
+            int plane = vertexOffsets[corner][2];
+            size_t slot = static_cast<size_t>(y + vertexOffsets[corner][1]) * sizeX + x + vertexOffsets[corner][0];
+            if (!gradientReady[plane][slot])
+            {
+                gradients[plane][slot] = gradientAt(x + vertexOffsets[corner][0], y + vertexOffsets[corner][1], z + plane);
+                gradientReady[plane][slot] = 1;
+            }
+            return gradients[plane][slot];
+        };
+
+        for (int y = 0; y < sizeY - 1; y++)
+        {
+            forEachActiveCube(y, z, cases, [&](int x, int cubeIndex) {
+                int edges = edgeTable[cubeIndex];
+
+                float cubeValues[8];
+                loadCorners(x, y, z, cubeValues);
+
+                // Obtener (o crear) el vértice de cada arista cortada
+                uint32_t edgeIds[12];
+                for (int i = 0; i < 12; i++)
+                {
+                    if (!(edges & (1 << i)))
+                    {
+                        continue;
+                    }
+
+                    int ex = x + edgeLocation[i][1];
+                    int ey = y + edgeLocation[i][2];
+                    int plane = edgeLocation[i][3];
+                    size_t slot = static_cast<size_t>(ey) * sizeX + ex;
+
+                    uint32_t *cached;
+                    switch (edgeLocation[i][0])
+                    {
+                    case 0:
+                        cached = &xEdges[plane][slot];
+                        break;
+                    case 1:
+                        cached = &yEdges[plane][slot];
+                        break;
+                    default:
+                        cached = &zEdges[slot];
+                        break;
+                    }
+
+                    if (*cached == noVertex)
+                    {
+                        // Interpolar siempre desde el vértice inferior de la arista
+                        int v0 = edgeVertices[i][0];
+                        int v1 = edgeVertices[i][1];
+                        if (vertexOffsets[v0][0] + vertexOffsets[v0][1] + vertexOffsets[v0][2] >
+                            vertexOffsets[v1][0] + vertexOffsets[v1][1] + vertexOffsets[v1][2])
+                        {
+                            std::swap(v0, v1);
+                        }
+
+                        Vertex p0(originX + x + vertexOffsets[v0][0],
+                                  originY + y + vertexOffsets[v0][1],
+                                  originZ + z + vertexOffsets[v0][2]);
+                        Vertex p1(originX + x + vertexOffsets[v1][0],
+                                  originY + y + vertexOffsets[v1][1],
+                                  originZ + z + vertexOffsets[v1][2]);
+
+                        *cached = static_cast<uint32_t>(mesh.vertices.size());
+                        if (computeNormals)
+                        {
+                            Vertex normal;
+                            mesh.vertices.push_back(interpolateVertex(p0, cubeValues[v0], cornerGradient(v0, x, y),
+                                                                      p1, cubeValues[v1], cornerGradient(v1, x, y),
+                                                                      normal));
+                            mesh.normals.push_back(normal);
+                        }
+                        else
+                        {
+                            mesh.vertices.push_back(interpolateVertex(p0, cubeValues[v0], p1, cubeValues[v1]));
+                        }
+                    }
+                    edgeIds[i] = *cached;
+                }
+
+                // Emitir los índices según la tabla de triangulación
+                for (int t = 0; t < triangleCounts[cubeIndex]; t++)
+                {
+                    mesh.indices.push_back(edgeIds[triangleEdge(cubeIndex, t, 0)]);
+                    mesh.indices.push_back(edgeIds[triangleEdge(cubeIndex, t, 1)]);
+                    mesh.indices.push_back(edgeIds[triangleEdge(cubeIndex, t, 2)]);
+                }
+            });
+        }
+
+        // Avanzar la ventana: el plano z+1 pasa a ser el plano z
+        std::swap(xEdges[0], xEdges[1]);
+        std::swap(yEdges[0], yEdges[1]);
+        std::fill(xEdges[1].begin(), xEdges[1].end(), noVertex);
+        std::fill(yEdges[1].begin(), yEdges[1].end(), noVertex);
+        std::fill(zEdges.begin(), zEdges.end(), noVertex);
+        if (computeNormals)
+        {
+            std::swap(gradients[0], gradients[1]);
+            std::swap(gradientReady[0], gradientReady[1]);
+            std::fill(gradientReady[1].begin(), gradientReady[1].end(), 0);
+        }
+    }
+
+    MC_METRIC_ADD(TRIANGLES_EMITTED, mesh.triangleCount());
+    return mesh.triangleCount();
+}
+
+// Genera una malla por isovalor recorriendo el volumen una sola vez
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurfaces(const std::vector<float> &isoValues,
+                                             std::vector<std::vector<Triangle>> &meshes) const
+{
+    meshes.assign(isoValues.size(), std::vector<Triangle>());
+
+    if (!hasScalarField())
+    {
+        std::cerr << "Error: Campo escalar no configurado correctamente." << std::endl;
+        return 0;
+    }
+
+    return generateIsosurfacesSlab(0, sizeZ - 1, isoValues, meshes);
+}
+
+// Versión multi-isovalor restringida a las capas z en [zBegin, zEnd)
+template <typename T>
+int MarchingCubesSerialT<T>::generateIsosurfacesSlab(int zBegin, int zEnd,
+                                                 const std::vector<float> &isoValues,
+                                                 std::vector<std::vector<Triangle>> &meshes) const
+{
+    const int numIso = static_cast<int>(isoValues.size());
+    if (meshes.size() < isoValues.size())
+    {
+        meshes.resize(isoValues.size());
+    }
+    if (numIso == 0)
+    {
+        return 0;
+    }
+
+    // Isovalores ordenados: un cubo con esquinas en [lo, hi] solo corta las
+    // superficies con lo < iso <= hi, que quedan contiguas en este orden
+    std::vector<int> order(numIso);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return isoValues[a] < isoValues[b]; });
+    // Los umbrales en el dominio almacenado conservan el orden (scale > 0)
+    std::vector<float> sorted(numIso);
+    std::vector<Key> thresholds(numIso);
+    for (int k = 0; k < numIso; k++)
+    {
+        sorted[k] = isoValues[order[k]];
+        thresholds[k] = toStoredThreshold(sorted[k]);
+    }
+
+    // Con índice de bricks: tramos de bricks que cortan al menos un isovalor
+    const bool bricks = brickIndex && !brickIndex->empty() && brickIndex->getSizeX() == sizeX &&
+                        brickIndex->getSizeY() == sizeY && brickIndex->getSizeZ() == sizeZ;
+    const int brickSize = bricks ? brickIndex->getBrickSize() : sizeX;
+    std::vector<std::vector<int>> spanRows;
+    if (bricks)
+    {
+        spanRows.resize(static_cast<size_t>(brickIndex->bricksY()) * brickIndex->bricksZ());
+        for (int bz = 0; bz < brickIndex->bricksZ(); bz++)
+        {
+            for (int by = 0; by < brickIndex->bricksY(); by++)
+            {
+                for (int bx = 0; bx < brickIndex->bricksX(); bx++)
+                {
+                    float lo = brickIndex->brickMin(bx, by, bz);
+                    float hi = brickIndex->brickMax(bx, by, bz);
+                    auto it = std::upper_bound(sorted.begin(), sorted.end(), lo);
+                    if (it != sorted.end() && *it <= hi)
+                    {
+                        spanRows[static_cast<size_t>(bz) * brickIndex->bricksY() + by].push_back(bx);
+                    }
+                }
+            }
+        }
+    }
+    const std::vector<int> fullRow(1, 0);
+
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, sizeZ - 1);
+
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+    Triangle cubeTriangles[5];
+    int total = 0;
+
+    for (int z = zBegin; z < zEnd; z++)
+    {
+        for (int y = 0; y < sizeY - 1; y++)
+        {
+            const std::vector<int> &spans =
+                bricks ? spanRows[static_cast<size_t>(z / brickSize) * brickIndex->bricksY() + y / brickSize]
+                       : fullRow;
+
+            const T *row00 = scalarField + z * planeSize + static_cast<size_t>(y) * sizeX;
+            const T *row10 = row00 + sizeX;
+            const T *row01 = row00 + planeSize;
+            const T *row11 = row01 + sizeX;
+
+            for (int span : spans)
+            {
+                int x0 = span * brickSize;
+                int x1 = std::min(x0 + brickSize, sizeX - 1);
+                for (int x = x0; x < x1; x++)
+                {
+                    // Cargar las 8 esquinas una sola vez para todos los isovalores
+                    const T corners[8] = {
+                        row00[x], row00[x + 1], row10[x + 1], row10[x],
+                        row01[x], row01[x + 1], row11[x + 1], row11[x]};
+
+                    Key keys[8];
+                    for (int i = 0; i < 8; i++)
+                    {
+                        keys[i] = ScalarTraits<T>::key(corners[i]);
+                    }
+                    Key lo = keys[0], hi = keys[0];
+                    for (int i = 1; i < 8; i++)
+                    {
+                        lo = std::min(lo, keys[i]);
+                        hi = std::max(hi, keys[i]);
+                    }
+
+                    // Corta las superficies con lo < umbral <= hi
+                    int k = std::upper_bound(thresholds.begin(), thresholds.end(), lo) - thresholds.begin();
+                    if (k == numIso || thresholds[k] > hi)
+                    {
+                        continue;
+                    }
+
+                    float cubeValues[8];
+                    for (int i = 0; i < 8; i++)
+                    {
+                        cubeValues[i] = decode(corners[i]);
+                    }
+
+                    for (; k < numIso && thresholds[k] <= hi; k++)
+                    {
+                        const float iso = sorted[k];
+                        int cubeIndex = 0;
+                        for (int i = 0; i < 8; i++)
+                        {
+                            cubeIndex |= (keys[i] < thresholds[k]) << i;
+                        }
+                        if (!triangleCounts[cubeIndex])
+                        {
+                            continue;
+                        }
+
+                        int count = polygonizeCube(x, y, z, cubeIndex, cubeValues, iso, cubeTriangles);
+                        std::vector<Triangle> &mesh = meshes[order[k]];
+                        mesh.insert(mesh.end(), cubeTriangles, cubeTriangles + count);
+                        total += count;
+                    }
+                }
+            }
+        }
+    }
+
+    MC_METRIC_ADD(TRIANGLES_EMITTED, total);
+    return total;
+}
+
+// Instancias para cada tipo de almacenamiento
+template class MarchingCubesSerialT<float>;
+template class MarchingCubesSerialT<uint8_t>;
+template class MarchingCubesSerialT<uint16_t>;
+template class MarchingCubesSerialT<Half>;
@@ -3,6 +3,11 @@
 
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include "brick_index.h"
+#include "marching_cube_tables.h"
+#include "src/scalar_types.h"
 
 // Estructura para representar un vértice 3D
 struct Vertex
@@ -39,53 +44,292 @@ struct Triangle
         : v0(a), v1(b), v2(c) {}
 };
 
-// Clase principal para el algoritmo Marching Cubes
-class MarchingCubesSerial
+// Malla indexada: cada vértice se almacena una sola vez y los triángulos
+// se describen con tres índices consecutivos en 'indices'. 'normals' es
+// opcional: vacío, o una normal unitaria por vértice
+struct IndexedMesh
+{
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<Vertex> normals;
+
+    size_t triangleCount() const { return indices.size() / 3; }
+    bool hasNormals() const { return !vertices.empty() && normals.size() == vertices.size(); }
+
+    void clear()
+    {
+        vertices.clear();
+        indices.clear();
+        normals.clear();
+    }
+};
+
+class MeshSink;
+class PhaseProfiler;
+
+// Clase principal para el algoritmo Marching Cubes.
+//
+// T es el tipo con el que se almacenan los vóxeles: float, uint8_t, uint16_t
+// o Half (ver src/scalar_types.h). Con tipos reducidos el valor real es
+// guardado * scale + offset (setValueMapping); el isovalor se traduce una vez
+// al dominio almacenado, de modo que la clasificación compara enteros y solo
+// las esquinas de los cubos activos se convierten a float para interpolar
+template <typename T>
+class MarchingCubesSerialT : public MarchingCubesTables
 {
 private:
-    // Tablas de lookup para el algoritmo
-    static const int edgeTable[256];
-    static const int triTable[256][16];
+    typedef typename ScalarTraits<T>::Key Key;
 
     // Datos del volumen
-    float *scalarField;
+    const T *scalarField;
     int sizeX, sizeY, sizeZ;
     float isoValue;
 
-    // Vértices de un cubo
-    static const int vertexOffsets[8][3];
+    // Correspondencia entre valor almacenado y real, y umbral de
+    // clasificación del isovalor en el dominio almacenado
+    float valueScale, valueOffset;
+    Key storedIso;
 
-    // Aristas del cubo
-    static const int edgeVertices[12][2];
+    // Recalcula storedIso tras cambiar el isovalor o la correspondencia
+    void updateStoredIso() { storedIso = toStoredThreshold(isoValue); }
+    Key toStoredThreshold(float iso) const
+    {
+        return ScalarTraits<T>::threshold((iso - valueOffset) / valueScale);
+    }
+
+    // Valor real de un vóxel almacenado
+    float decode(T v) const { return ScalarTraits<T>::toFloat(v) * valueScale + valueOffset; }
+
+    // Posición global del vóxel (0, 0, 0) del campo configurado
+    int originX, originY, originZ;
 
     // Interpola entre dos vértices basándose en el isovalor
     Vertex interpolateVertex(const Vertex &v1, float val1,
                              const Vertex &v2, float val2) const;
+    static Vertex interpolateVertex(const Vertex &v1, float val1,
+                                    const Vertex &v2, float val2, float iso);
+
+    // Igual, interpolando con el mismo peso los gradientes g1 y g2 de los
+    // extremos; en 'normal' deja la normal unitaria resultante
+    Vertex interpolateVertex(const Vertex &v1, float val1, const Vertex &g1,
+                             const Vertex &v2, float val2, const Vertex &g2,
+                             Vertex &normal) const;
+
+    // Peso t del punto de corte entre dos valores (0 = primer extremo)
+    static float interpolationWeight(float val1, float val2, float iso);
+
+    // Normales por vértice en generateIndexedMesh
+    bool computeNormals;
 
-    // Obtiene el valor escalar en una posición del grid
+    // Gradiente del campo (real) en un vóxel por diferencias centradas
+    // (laterales en los bordes)
+    Vertex gradientAt(int x, int y, int z) const;
+
+    // Obtiene el valor escalar (real) en una posición del grid. Comprueba
+    // los límites (fuera del grid devuelve 0): solo para consultas sueltas
     float getScalarValue(int x, int y, int z) const;
 
+    // Desplazamiento de cada esquina del cubo respecto a su esquina 0 dentro
+    // del campo configurado (se calcula en setScalarField)
+    ptrdiff_t cornerOffsets[8];
+
+    // Carga los valores reales de las 8 esquinas del cubo (x, y, z) con
+    // lecturas directas, sin comprobar límites. Los recorridos solo visitan
+    // cubos interiores (x < sizeX - 1, y < sizeY - 1, z < sizeZ - 1), cuyas
+    // esquinas están siempre dentro del campo
+    void loadCorners(int x, int y, int z, float cubeValues[8]) const
+    {
+        const T *corner0 = scalarField + (static_cast<size_t>(z) * sizeY + y) * sizeX + x;
+        for (int i = 0; i < 8; i++)
+        {
+            cubeValues[i] = decode(corner0[cornerOffsets[i]]);
+        }
+    }
+
+    // Índice de configuración de un cubo interior, con las mismas lecturas
+    // directas que loadCorners (sin comprobar límites)
+    int interiorCubeIndex(int x, int y, int z) const
+    {
+        const T *corner0 = scalarField + (static_cast<size_t>(z) * sizeY + y) * sizeX + x;
+        int cubeIndex = 0;
+        for (int i = 0; i < 8; i++)
+        {
+            cubeIndex |= (ScalarTraits<T>::key(corner0[cornerOffsets[i]]) < storedIso) << i;
+        }
+        return cubeIndex;
+    }
+
+    // Clave de clasificación del vóxel almacenado en una posición del grid
+    // (comprueba límites: solo para los cubos del borde)
+    Key getStoredKey(int x, int y, int z) const;
+
     // Procesa un cubo individual
-    void processCube(int x, int y, int z, std::vector<Triangle> &triangles);
+    void processCube(int x, int y, int z, std::vector<Triangle> &triangles) const;
+
+    // Triangula un cubo interior cuyo índice de configuración ya es conocido
+    int polygonizeCube(int x, int y, int z, int cubeIndex, Triangle *out) const;
+
+    // Triangula un cubo a partir de los valores ya cargados de sus esquinas
+    // para el isovalor 'iso'
+    int polygonizeCube(int x, int y, int z, int cubeIndex,
+                       const float cubeValues[8], float iso, Triangle *out) const;
+
+    // Las dos mitades de polygonizeCube: cruces en las aristas cortadas y
+    // ensamblado de los triángulos de la configuración
+    void interpolateEdges(int x, int y, int z, int cubeIndex,
+                          const float cubeValues[8], float iso, Vertex vertList[12]) const;
+    static int assembleTriangles(int cubeIndex, const Vertex vertList[12], Triangle *out);
+
+    // Salto de espacio vacío: jerarquía min/max (no es propiedad de la clase)
+    // y, para el isovalor preparado, los bx activos de cada fila de bricks
+    // (by, bz) en orden creciente
+    const BrickIndex *brickIndex;
+    std::vector<std::vector<int>> activeBrickRows;
+    bool activeBricksReady;
+    float activeBricksIso;
+
+    // Indica si los bricks activos corresponden al isovalor actual
+    bool usesBricks() const
+    {
+        return brickIndex && activeBricksReady && activeBricksIso == isoValue;
+    }
+
+    // Clasifica la fila (y, z) (solo los tramos de bricks activos si hay
+    // índice) y llama a fn(x, cubeIndex) por cada cubo que genera triángulos
+    template <typename CubeFunc>
+    void forEachActiveCube(int y, int z, unsigned char *cases, CubeFunc fn) const;
 
 public:
     // Constructor
-    MarchingCubesSerial();
+    MarchingCubesSerialT();
 
     // Destructor
-    ~MarchingCubesSerial();
+    ~MarchingCubesSerialT();
 
     // Configura los datos del volumen
-    void setScalarField(float *data, int sx, int sy, int sz);
+    void setScalarField(const T *data, int sx, int sy, int sz);
+
+    // Establece el isovalor (en unidades reales)
+    void setIsoValue(float value)
+    {
+        isoValue = value;
+        updateStoredIso();
+    }
 
-    // Establece el isovalor
-    void setIsoValue(float value) { isoValue = value; }
+    float getIsoValue() const { return isoValue; }
+
+    // Valor real = guardado * scale + offset (por defecto 1 y 0). scale
+    // debe ser positiva; el índice de bricks, si lo hay, debe describir los
+    // valores reales
+    void setValueMapping(float scale, float offset);
+
+    // Desplaza los vértices generados: útil cuando el campo configurado es
+    // solo una parte (slab, ventana o brick) de un volumen mayor
+    void setOrigin(int ox, int oy, int oz)
+    {
+        originX = ox;
+        originY = oy;
+        originZ = oz;
+    }
+
+    // Asocia una jerarquía min/max construida sobre el mismo campo para
+    // saltar los bricks cuyo rango no contiene el isovalor (nullptr la quita)
+    void setBrickIndex(const BrickIndex *index);
+
+    // Calcula los bricks activos para el isovalor actual. generateIsosurface
+    // y generateIndexedMesh lo llaman solos; los motores que usan
+    // generateIsosurfaceSlab o las funciones por fila deben llamarlo antes
+    void prepareActiveBricks();
 
     // Ejecuta el algoritmo y devuelve los triángulos generados
     std::vector<Triangle> generateIsosurface();
 
     // Versión que devuelve el número de triángulos generados
     int generateIsosurface(std::vector<Triangle> &triangles);
+
+    // Entrega los triángulos a 'sink' a medida que se generan, por bloques,
+    // sin acumularlos en memoria. Devuelve el número de triángulos generados
+    long long generateIsosurface(MeshSink &sink);
+
+    // Igual que generateIsosurface, pero registra en 'profiler' el tiempo y
+    // los contadores de hardware de las fases de clasificación, interpolación
+    // y emisión. Más lenta que la versión normal: solo para análisis
+    int generateIsosurfaceProfiled(std::vector<Triangle> &triangles, PhaseProfiler &profiler);
+
+    // Genera una malla indexada sin vértices duplicados: cada cruce de arista
+    // se interpola una sola vez y se comparte entre los cubos vecinos.
+    // Devuelve el número de triángulos generados
+    int generateIndexedMesh(IndexedMesh &mesh);
+
+    // Con normales activadas, generateIndexedMesh rellena también
+    // mesh.normals a partir del gradiente del campo. Los gradientes solo se
+    // calculan en las esquinas de los cubos activos y se guardan por plano z
+    // para que los cubos vecinos los reutilicen
+    void setComputeNormals(bool enabled) { computeNormals = enabled; }
+    bool getComputeNormals() const { return computeNormals; }
+
+    // Genera una malla por cada isovalor en un único recorrido del volumen:
+    // las esquinas de cada cubo se cargan una vez y se clasifican contra todos
+    // los isovalores. meshes[k] es idéntica a la que se obtendría con
+    // setIsoValue(isoValues[k]) + generateIsosurface. Devuelve el total de triángulos
+    int generateIsosurfaces(const std::vector<float> &isoValues,
+                            std::vector<std::vector<Triangle>> &meshes) const;
+
+    // Versión multi-isovalor restringida a las capas z en [zBegin, zEnd);
+    // añade los triángulos al final de cada malla
+    int generateIsosurfacesSlab(int zBegin, int zEnd, const std::vector<float> &isoValues,
+                                std::vector<std::vector<Triangle>> &meshes) const;
+
+    // Procesa solo los cubos con z en [zBegin, zEnd) y añade los triángulos
+    // al final de 'triangles' (usado por los motores paralelos)
+    int generateIsosurfaceSlab(int zBegin, int zEnd, std::vector<Triangle> &triangles) const;
+
+    // Versión con MeshSink restringida a las capas z en [zBegin, zEnd)
+    long long generateIsosurfaceSlab(int zBegin, int zEnd, MeshSink &sink) const;
+
+    // Procesa solo los cubos de la caja [x0, x1) x [y0, y1) x [z0, z1) y
+    // añade los triángulos al final de 'triangles' (usado por el planificador
+    // de bricks). No consulta el índice de bricks: quien llama elige las cajas
+    int generateIsosurfaceBox(int x0, int y0, int z0, int x1, int y1, int z1,
+                              std::vector<Triangle> &triangles) const;
+
+    // Índice de configuración (0-255) del cubo con esquina inferior (x, y, z),
+    // comprobando los límites en cada esquina (cubos del borde o exteriores)
+    int getCubeIndex(int x, int y, int z) const;
+
+    // Escribe en 'cases' el índice de configuración de los sizeX - 1 cubos
+    // de la fila (y, z) usando el núcleo vectorizado de cube_classifier.h
+    void classifyRow(int y, int z, unsigned char *cases) const;
+
+    // Triangula un cubo escribiendo a lo sumo 5 triángulos en 'out'.
+    // Devuelve el número de triángulos escritos
+    int polygonizeCube(int x, int y, int z, Triangle *out) const;
+
+    // Cuenta los triángulos de la fila de cubos (y, z) sin generarlos
+    int countRowTriangles(int y, int z) const;
+
+    // Escribe en 'out' los triángulos de la fila de cubos (y, z); 'out' debe
+    // tener espacio para countRowTriangles(y, z) triángulos
+    int emitRowTriangles(int y, int z, Triangle *out) const;
+
+    // Consultas del volumen configurado
+    bool hasScalarField() const { return scalarField && sizeX > 0 && sizeY > 0 && sizeZ > 0; }
+    int getSizeX() const { return sizeX; }
+    int getSizeY() const { return sizeY; }
+    int getSizeZ() const { return sizeZ; }
 };
 
+// Motor sobre vóxeles float (el formato de los archivos .bin) y variantes
+// de almacenamiento reducido
+typedef MarchingCubesSerialT<float> MarchingCubesSerial;
+typedef MarchingCubesSerialT<uint8_t> MarchingCubesSerialU8;
+typedef MarchingCubesSerialT<uint16_t> MarchingCubesSerialU16;
+typedef MarchingCubesSerialT<Half> MarchingCubesSerialHalf;
+
+// Las instancias se compilan en marching_cube_serial.cpp
+extern template class MarchingCubesSerialT<float>;
+extern template class MarchingCubesSerialT<uint8_t>;
+extern template class MarchingCubesSerialT<uint16_t>;
+extern template class MarchingCubesSerialT<Half>;
+
 #endif // MARCHING_CUBES_SERIAL_H
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "marching_cube_streaming.h"
+#include "src/metrics.h"
+#include "src/volume_io.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+MarchingCubesStreaming::MarchingCubesStreaming()
+    : fd(-1), sizeX(0), sizeY(0), sizeZ(0), slabDepth(16), isoValue(0.0f)
+{
+}
+
+MarchingCubesStreaming::~MarchingCubesStreaming()
+{
+    close();
+}
+
+// Abre el archivo y lee la cabecera. El tamaño del archivo se valida aquí:
+// un archivo truncado no debe descubrirse a mitad de la malla
+bool MarchingCubesStreaming::open(const std::string &filename)
+{
+    close();
+
+    int nx, ny, nz;
+    if (!readVolumeHeader(filename, nx, ny, nz))
+    {
+        return false;
+    }
+    if (nx <= 1 || ny <= 1 || nz <= 1)
+    {
+        std::cerr << "Error: Cabecera inválida en " << filename << std::endl;
+        return false;
+    }
+
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
+        return false;
+    }
+
+    sizeX = nx;
+    sizeY = ny;
+    sizeZ = nz;
+
+    // El archivo se lee una sola vez y en orden
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return true;
+}
+
+void MarchingCubesStreaming::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    fd = -1;
+    sizeX = sizeY = sizeZ = 0;
+}
+
+// Bytes de la ventana de planos con la configuración actual
+size_t MarchingCubesStreaming::windowBytes() const
+{
+    return static_cast<size_t>(sizeX) * sizeY * (slabDepth + 1) * sizeof(float);
+}
+
+// Lee 'count' planos a partir del plano z en 'dest'
+bool MarchingCubesStreaming::readPlanes(int z, int count, float *dest) const
+{
+    const off_t headerSize = static_cast<off_t>(VOLUME_HEADER_SIZE);
+    const size_t planeBytes = static_cast<size_t>(sizeX) * sizeY * sizeof(float);
+    size_t remaining = planeBytes * count;
+    off_t offset = headerSize + static_cast<off_t>(planeBytes) * z;
+    char *out = reinterpret_cast<char *>(dest);
+
+    while (remaining > 0)
+    {
+        ssize_t got = pread(fd, out, remaining, offset);
+        if (got <= 0)
+        {
+            return false;
+        }
+        out += got;
+        offset += got;
+        remaining -= got;
+    }
+    MC_METRIC_ADD(BYTES_READ, planeBytes * count);
+
+    // Los planos ya leídos no se volverán a usar: liberar la caché de páginas
+    posix_fadvise(fd, headerSize, offset - headerSize - static_cast<off_t>(planeBytes), POSIX_FADV_DONTNEED);
+    return true;
+}
+
+// Recorre el archivo por ventanas de planos y emite los triángulos por slab
+long long MarchingCubesStreaming::generateIsosurface(const TriangleCallback &emit)
+{
+    if (fd < 0)
+    {
+        std::cerr << "Error: Archivo no abierto." << std::endl;
+        return -1;
+    }
+
+    const size_t planeSize = static_cast<size_t>(sizeX) * sizeY;
+    std::vector<float> window(planeSize * (slabDepth + 1));
+    std::vector<Triangle> triangles;
+
+    MarchingCubesSerial engine;
+    engine.setIsoValue(isoValue);
+
+    long long total = 0;
+    int planesInWindow = 0;
+
+    // La ventana cubre los planos [zBase, zBase + planesInWindow)
+    for (int zBase = 0; zBase < sizeZ - 1; zBase += slabDepth)
+    {
+        int wanted = std::min(slabDepth + 1, sizeZ - zBase);
+
+        if (planesInWindow == 0)
+        {
+            // Primera ventana: leer todos sus planos
+            if (!readPlanes(zBase, wanted, window.data()))
+            {
+                std::cerr << "Error: Lectura fallida en el plano " << zBase << std::endl;
+                return -1;
+            }
+        }
+        else
+        {
+            // El último plano de la ventana anterior es el primero de ésta
+            std::memcpy(window.data(), window.data() + planeSize * (planesInWindow - 1),
+                        planeSize * sizeof(float));
+            if (!readPlanes(zBase + 1, wanted - 1, window.data() + planeSize))
+            {
+                std::cerr << "Error: Lectura fallida en el plano " << zBase + 1 << std::endl;
+                return -1;
+            }
+        }
+        planesInWindow = wanted;
+
+        // Los vértices se generan directamente en coordenadas globales
+        engine.setScalarField(window.data(), sizeX, sizeY, planesInWindow);
+        engine.setOrigin(0, 0, zBase);
+        engine.generateIsosurface(triangles);
+
+        total += triangles.size();
+        emit(triangles);
+    }
+
+    return total;
+}
+
+// Igual, entregando los triángulos de cada slab a un MeshSink
+long long MarchingCubesStreaming::generateIsosurface(MeshSink &sink)
+{
+    return generateIsosurface([&sink](const std::vector<Triangle> &triangles) {
+        sink.addTriangles(triangles.data(), triangles.size());
+    });
+}
@@ -0,0 +1,62 @@
+#ifndef MARCHING_CUBES_STREAMING_H
+#define MARCHING_CUBES_STREAMING_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "marching_cube_serial.h"
+#include "mesh_sink.h"
+
+// Extracción "out-of-core": recorre un archivo .bin (cabecera nx, ny, nz +
+// floats con x más rápido) por ventanas de planos z y entrega los triángulos
+// de cada ventana a medida que se generan. Nunca se carga el volumen completo:
+// la memoria usada es (slabDepth + 1) planos más los triángulos de un slab,
+// sin importar el tamaño del archivo.
+class MarchingCubesStreaming
+{
+public:
+    // Recibe los triángulos de cada slab (en coordenadas globales)
+    typedef std::function<void(const std::vector<Triangle> &)> TriangleCallback;
+
+    MarchingCubesStreaming();
+    ~MarchingCubesStreaming();
+
+    MarchingCubesStreaming(const MarchingCubesStreaming &) = delete;
+    MarchingCubesStreaming &operator=(const MarchingCubesStreaming &) = delete;
+
+    // Abre el archivo y lee la cabecera
+    bool open(const std::string &filename);
+    void close();
+
+    // Establece el isovalor
+    void setIsoValue(float value) { isoValue = value; }
+
+    // Capas de cubos por ventana (la ventana contiene slabDepth + 1 planos)
+    void setSlabDepth(int depth) { slabDepth = depth > 0 ? depth : 1; }
+
+    // Dimensiones del archivo abierto
+    int getSizeX() const { return sizeX; }
+    int getSizeY() const { return sizeY; }
+    int getSizeZ() const { return sizeZ; }
+
+    // Bytes de la ventana de planos con la configuración actual
+    size_t windowBytes() const;
+
+    // Recorre el archivo y llama a 'emit' una vez por slab.
+    // Devuelve el número total de triángulos o -1 si hubo un error de lectura
+    long long generateIsosurface(const TriangleCallback &emit);
+
+    // Igual, entregando los triángulos de cada slab a 'sink'
+    long long generateIsosurface(MeshSink &sink);
+
+private:
+    // Lee 'count' planos a partir del plano z en 'dest'
+    bool readPlanes(int z, int count, float *dest) const;
+
+    int fd;
+    int sizeX, sizeY, sizeZ;
+    int slabDepth;
+    float isoValue;
+};
+
+#endif // MARCHING_CUBES_STREAMING_H
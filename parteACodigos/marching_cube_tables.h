@@ -0,0 +1,294 @@
+#ifndef MARCHING_CUBE_TABLES_H
+#define MARCHING_CUBE_TABLES_H
+
+#include <array>
+#include <cstdint>
+
+// Tablas de casos de Marching Cubes.
+//
+// La triangulación de las 256 configuraciones no se escribe a mano: se genera
+// en tiempo de compilación a partir de la topología del cubo. En cada cara,
+// el contorno rodea cada tramo de esquinas marcadas (valor < isovalor); en las
+// caras ambiguas (dos esquinas marcadas opuestas) las esquinas marcadas
+// quedan separadas. La decisión solo depende de la cara, así que dos cubos
+// vecinos generan el mismo contorno sobre la cara común y la malla es cerrada.
+// Los contornos se encadenan arista a arista y cada uno se triangula en abanico.
+// La normal de cada triángulo apunta hacia las esquinas marcadas, como en la
+// tabla clásica de Lorensen y Cline.
+
+// Topología del cubo y tabla clásica de aristas cortadas
+struct CubeTopology
+{
+    // Vértices de un cubo
+    static constexpr int vertexOffsets[8][3] = {
+        {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+
+    // Aristas del cubo
+    static constexpr int edgeVertices[12][2] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+    // Ubicación de cada arista en la caché de aristas: eje (0=x, 1=y, 2=z)
+    // y desplazamiento (dx, dy, dz) de su vértice inferior dentro del cubo
+    static constexpr int edgeLocation[12][4] = {
+        {0, 0, 0, 0}, {1, 1, 0, 0}, {0, 0, 1, 0}, {1, 0, 0, 0}, {0, 0, 0, 1}, {1, 1, 0, 1}, {0, 0, 1, 1}, {1, 0, 0, 1}, {2, 0, 0, 0}, {2, 1, 0, 0}, {2, 1, 1, 0}, {2, 0, 1, 0}};
+
+    // Esquinas de cada cara en sentido antihorario vistas desde fuera
+    static constexpr int faceVertices[6][4] = {
+        {0, 3, 2, 1}, {4, 5, 6, 7}, {0, 1, 5, 4}, {3, 7, 6, 2}, {0, 4, 7, 3}, {1, 2, 6, 5}};
+
+    // Tabla de aristas: indica qué aristas están cortadas por la isosuperficie.
+    // Se comprueba en compilación contra la triangulación generada
+    static constexpr uint16_t edgeTable[256] = {
+        0x0, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
+        0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
+        0x190, 0x99, 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
+        0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
+        0x230, 0x339, 0x33, 0x13a, 0x636, 0x73f, 0x435, 0x53c,
+        0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
+        0x3a0, 0x2a9, 0x1a3, 0xaa, 0x7a6, 0x6af, 0x5a5, 0x4ac,
+        0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
+        0x460, 0x569, 0x663, 0x76a, 0x66, 0x16f, 0x265, 0x36c,
+        0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
+        0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff, 0x3f5, 0x2fc,
+        0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
+        0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55, 0x15c,
+        0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
+        0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc,
+        0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
+        0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
+        0xcc, 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
+        0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
+        0x15c, 0x55, 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
+        0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
+        0x2fc, 0x3f5, 0xff, 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
+        0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
+        0x36c, 0x265, 0x16f, 0x66, 0x76a, 0x663, 0x569, 0x460,
+        0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
+        0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa, 0x1a3, 0x2a9, 0x3a0,
+        0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
+        0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33, 0x339, 0x230,
+        0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
+        0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99, 0x190,
+        0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
+        0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0};
+};
+
+// Triangulación de una configuración: 'count' triángulos cuyas aristas
+// están en edges[3 * t .. 3 * t + 2]. Un contorno de k aristas da k - 2
+// triángulos, así que 12 aristas dan como mucho 10
+struct CubeCase
+{
+    int count;
+    int edges[30];
+};
+
+// Arista que une las esquinas a y b (-1 si no son vecinas)
+constexpr int cubeEdgeBetween(int a, int b)
+{
+    for (int e = 0; e < 12; e++)
+    {
+        int v0 = CubeTopology::edgeVertices[e][0];
+        int v1 = CubeTopology::edgeVertices[e][1];
+        if ((v0 == a && v1 == b) || (v0 == b && v1 == a))
+        {
+            return e;
+        }
+    }
+    return -1;
+}
+
+// Indica si las aristas a y b están en una misma cara del cubo
+constexpr bool cubeEdgesShareFace(int a, int b)
+{
+    for (int f = 0; f < 6; f++)
+    {
+        bool hasA = false, hasB = false;
+        for (int i = 0; i < 4; i++)
+        {
+            int e = cubeEdgeBetween(CubeTopology::faceVertices[f][i], CubeTopology::faceVertices[f][(i + 1) % 4]);
+            hasA = hasA || e == a;
+            hasB = hasB || e == b;
+        }
+        if (hasA && hasB)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Genera la triangulación de la configuración 'cubeIndex'
+constexpr CubeCase triangulateCase(int cubeIndex)
+{
+    // Contornos sobre las caras: next[e] es la arista que sigue a la arista
+    // cortada e (-1 si e no está cortada)
+    int next[12] = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+    for (int f = 0; f < 6; f++)
+    {
+        const int *face = CubeTopology::faceVertices[f];
+        for (int a = 0; a < 4; a++)
+        {
+            // Cada tramo de esquinas marcadas empieza en a y acaba en b
+            bool marked = (cubeIndex >> face[a]) & 1;
+            bool previousMarked = (cubeIndex >> face[(a + 3) % 4]) & 1;
+            if (!marked || previousMarked)
+            {
+                continue;
+            }
+            int b = a;
+            while ((cubeIndex >> face[(b + 1) % 4]) & 1)
+            {
+                b = (b + 1) % 4;
+            }
+
+            // El contorno sale del tramo por la arista de b y vuelve por la de a
+            next[cubeEdgeBetween(face[b], face[(b + 1) % 4])] = cubeEdgeBetween(face[(a + 3) % 4], face[a]);
+        }
+    }
+
+    // Encadenar cada contorno y triangularlo en abanico
+    CubeCase result{};
+    bool visited[12] = {};
+    for (int e = 0; e < 12; e++)
+    {
+        if (next[e] < 0 || visited[e])
+        {
+            continue;
+        }
+
+        int loop[12] = {};
+        int length = 0;
+        for (int current = e; !visited[current]; current = next[current])
+        {
+            visited[current] = true;
+            loop[length++] = current;
+        }
+
+        // El vértice común del abanico se elige de modo que ninguna diagonal
+        // una dos aristas de la misma cara: esa diagonal quedaría sobre la
+        // cara y el cubo vecino podría generar la misma, duplicando la arista.
+        // Si no hubiera ninguno válido, count = -1 hace fallar la comprobación
+        int apex = -1;
+        for (int r = 0; r < length; r++)
+        {
+            bool valid = true;
+            for (int i = 2; i < length - 1; i++)
+            {
+                valid = valid && !cubeEdgesShareFace(loop[r], loop[(r + i) % length]);
+            }
+            if (valid)
+            {
+                apex = r;
+                break;
+            }
+        }
+        if (apex < 0)
+        {
+            result.count = -1;
+            return result;
+        }
+
+        for (int i = 1; i < length - 1; i++)
+        {
+            result.edges[3 * result.count] = loop[apex];
+            result.edges[3 * result.count + 1] = loop[(apex + i) % length];
+            result.edges[3 * result.count + 2] = loop[(apex + i + 1) % length];
+            result.count++;
+        }
+    }
+    return result;
+}
+
+// Comprueba que cada configuración se puede triangular, genera a lo sumo 5
+// triángulos y usa exactamente las aristas cortadas según edgeTable
+constexpr bool caseTablesAreConsistent()
+{
+    for (int c = 0; c < 256; c++)
+    {
+        CubeCase triangulation = triangulateCase(c);
+        if (triangulation.count < 0 || triangulation.count > 5)
+        {
+            return false;
+        }
+
+        int cut = 0;
+        for (int e = 0; e < 12; e++)
+        {
+            int v0 = CubeTopology::edgeVertices[e][0];
+            int v1 = CubeTopology::edgeVertices[e][1];
+            if (((c >> v0) & 1) != ((c >> v1) & 1))
+            {
+                cut |= 1 << e;
+            }
+        }
+
+        int used = 0;
+        for (int i = 0; i < 3 * triangulation.count; i++)
+        {
+            used |= 1 << triangulation.edges[i];
+        }
+
+        if (cut != CubeTopology::edgeTable[c] || used != cut)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(caseTablesAreConsistent(),
+              "edgeTable no coincide con la triangulación generada");
+
+// Tabla compacta: 64 bits por configuración. Los bits 60-63 guardan el número
+// de triángulos (0-5) y, desde el bit 0, cada arista ocupa 4 bits en el orden
+// de los vértices de los triángulos. Son 2 KB frente a los 16 KB de int[256][16]
+constexpr std::array<uint64_t, 256> buildTriangleTable()
+{
+    std::array<uint64_t, 256> table{};
+    for (int c = 0; c < 256; c++)
+    {
+        CubeCase triangulation = triangulateCase(c);
+        uint64_t packed = static_cast<uint64_t>(triangulation.count) << 60;
+        for (int i = 0; i < 3 * triangulation.count; i++)
+        {
+            packed |= static_cast<uint64_t>(triangulation.edges[i]) << (4 * i);
+        }
+        table[c] = packed;
+    }
+    return table;
+}
+
+// Número de triángulos (0-5) de cada configuración
+constexpr std::array<unsigned char, 256> buildTriangleCounts()
+{
+    std::array<unsigned char, 256> counts{};
+    for (int c = 0; c < 256; c++)
+    {
+        counts[c] = static_cast<unsigned char>(triangulateCase(c).count);
+    }
+    return counts;
+}
+
+// Tablas de lookup del algoritmo, compartidas por todos los motores y tipos
+// de vóxel
+class MarchingCubesTables : protected CubeTopology
+{
+protected:
+    // Triangulación compacta de cada configuración (ver buildTriangleTable)
+    static constexpr std::array<uint64_t, 256> triangleTable = buildTriangleTable();
+
+    // Número de triángulos (0-5) que genera cada configuración de cubo
+    static constexpr std::array<unsigned char, 256> triangleCounts = buildTriangleCounts();
+
+    // Arista del vértice v (0-2) del triángulo t de una configuración
+    static int triangleEdge(int cubeIndex, int t, int v)
+    {
+        return static_cast<int>((triangleTable[cubeIndex] >> (12 * t + 4 * v)) & 0xF);
+    }
+
+public:
+    // Número de triángulos que genera una configuración de cubo
+    static int getTriangleCount(int cubeIndex) { return triangleCounts[cubeIndex]; }
+};
+
+#endif // MARCHING_CUBE_TABLES_H
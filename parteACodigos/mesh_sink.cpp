@@ -0,0 +1,402 @@
+#include "mesh_sink.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Máximo de buffers llenos esperando al hilo escritor
+static const size_t MAX_PENDING_BUFFERS = 2;
+
+BufferedFileWriter::BufferedFileWriter()
+    : fd(-1), capacity(0), error(false), threaded(false), stopping(false), busy(0)
+{
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    close();
+}
+
+// Crea (o trunca) el archivo
+bool BufferedFileWriter::open(const std::string &filename, size_t bufferBytes, bool writerThread)
+{
+    close();
+
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+
+    capacity = bufferBytes > 0 ? bufferBytes : 1;
+    current.clear();
+    current.reserve(capacity);
+    error = false;
+
+    threaded = writerThread;
+    stopping = false;
+    busy = 0;
+    if (threaded)
+    {
+        writer = std::thread(&BufferedFileWriter::writerLoop, this);
+    }
+    return true;
+}
+
+// Escribe un bloque completo en la posición actual del archivo
+void BufferedFileWriter::writeAll(const char *data, size_t bytes)
+{
+    while (bytes > 0 && !error)
+    {
+        ssize_t written = ::write(fd, data, bytes);
+        if (written <= 0)
+        {
+            std::cerr << "Error: Fallo de escritura en la malla de salida." << std::endl;
+            error = true;
+            return;
+        }
+        data += written;
+        bytes -= written;
+    }
+}
+
+// Escritura que no cabe en el buffer actual
+void BufferedFileWriter::writeSlow(const void *data, size_t bytes)
+{
+    submit();
+    if (bytes > capacity)
+    {
+        // Bloques mayores que el buffer: directo, respetando el orden
+        flush();
+        writeAll(static_cast<const char *>(data), bytes);
+        return;
+    }
+    current.insert(current.end(), static_cast<const char *>(data), static_cast<const char *>(data) + bytes);
+}
+
+// Entrega el buffer actual al hilo escritor (o lo escribe directamente)
+void BufferedFileWriter::submit()
+{
+    if (current.empty())
+    {
+        return;
+    }
+
+    if (!threaded)
+    {
+        writeAll(current.data(), current.size());
+        current.clear();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // Contrapresión: no acumular más de MAX_PENDING_BUFFERS buffers llenos
+    changed.wait(lock, [&] { return pending.size() < MAX_PENDING_BUFFERS; });
+    pending.push_back(std::move(current));
+
+    if (!spare.empty())
+    {
+        current = std::move(spare.back());
+        spare.pop_back();
+    }
+    else
+    {
+        current = std::vector<char>();
+        current.reserve(capacity);
+    }
+    current.clear();
+    changed.notify_all();
+}
+
+// Bucle del hilo escritor
+void BufferedFileWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        changed.wait(lock, [&] { return stopping || !pending.empty(); });
+        if (pending.empty())
+        {
+            return;
+        }
+
+        std::vector<char> buffer = std::move(pending.front());
+        pending.pop_front();
+        busy++;
+
+        lock.unlock();
+        writeAll(buffer.data(), buffer.size());
+        buffer.clear();
+        lock.lock();
+
+        busy--;
+        spare.push_back(std::move(buffer));
+        changed.notify_all();
+    }
+}
+
+// Escribe todo lo pendiente y espera al hilo escritor
+bool BufferedFileWriter::flush()
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    submit();
+    if (threaded)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return pending.empty() && busy == 0; });
+    }
+    return !error;
+}
+
+// Sobrescribe bytes ya escritos
+bool BufferedFileWriter::writeAt(uint64_t offset, const void *data, size_t bytes)
+{
+    if (!flush())
+    {
+        return false;
+    }
+    if (pwrite(fd, data, bytes, static_cast<off_t>(offset)) != static_cast<ssize_t>(bytes))
+    {
+        error = true;
+        return false;
+    }
+    return true;
+}
+
+// flush + cierre
+bool BufferedFileWriter::close()
+{
+    if (fd < 0)
+    {
+        return !error;
+    }
+
+    flush();
+
+    if (threaded)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+        threaded = false;
+        spare.clear();
+    }
+
+    if (::close(fd) != 0)
+    {
+        error = true;
+    }
+    fd = -1;
+    current.clear();
+    current.shrink_to_fit();
+    return !error;
+}
+
+// ---------------------------------------------------------------------------
+// STL binario
+
+bool BinaryStlSink::open(const std::string &filename, size_t bufferBytes, bool writerThread)
+{
+    total = 0;
+    if (!out.open(filename, bufferBytes, writerThread))
+    {
+        return false;
+    }
+
+    char header[80];
+    std::memset(header, 0, sizeof(header));
+    std::snprintf(header, sizeof(header), "Marching Cubes isosurface");
+    uint32_t placeholder = 0;
+    out.write(header, sizeof(header));
+    out.write(&placeholder, sizeof(placeholder));
+    return true;
+}
+
+void BinaryStlSink::addTriangles(const Triangle *triangles, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const Triangle &t = triangles[i];
+
+        // Normal de la cara (puede ser nula en triángulos degenerados)
+        Vertex e1 = t.v1 - t.v0;
+        Vertex e2 = t.v2 - t.v0;
+        float n[3] = {e1.y * e2.z - e1.z * e2.y,
+                      e1.z * e2.x - e1.x * e2.z,
+                      e1.x * e2.y - e1.y * e2.x};
+        float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length > 0.0f)
+        {
+            n[0] /= length;
+            n[1] /= length;
+            n[2] /= length;
+        }
+
+        // 12 floats + 2 bytes de atributo
+        char record[50];
+        const float values[12] = {n[0], n[1], n[2],
+                                  t.v0.x, t.v0.y, t.v0.z,
+                                  t.v1.x, t.v1.y, t.v1.z,
+                                  t.v2.x, t.v2.y, t.v2.z};
+        std::memcpy(record, values, sizeof(values));
+        record[48] = record[49] = 0;
+        out.write(record, sizeof(record));
+    }
+    total += count;
+}
+
+bool BinaryStlSink::finish()
+{
+    if (!out.isOpen())
+    {
+        return false;
+    }
+    if (total > UINT32_MAX)
+    {
+        std::cerr << "Error: STL binario admite como máximo 2^32-1 triángulos." << std::endl;
+        out.close();
+        return false;
+    }
+
+    uint32_t count32 = static_cast<uint32_t>(total);
+    bool ok = out.writeAt(80, &count32, sizeof(count32));
+    return out.close() && ok;
+}
+
+// ---------------------------------------------------------------------------
+// PLY binario
+
+// Ancho fijo reservado para los contadores de la cabecera
+static const int PLY_COUNT_WIDTH = 20;
+
+// Escribe un contador de la cabecera con ancho fijo (relleno con espacios)
+static std::string plyCount(uint64_t value)
+{
+    char text[PLY_COUNT_WIDTH + 1];
+    std::snprintf(text, sizeof(text), "%-*llu", PLY_COUNT_WIDTH, static_cast<unsigned long long>(value));
+    return text;
+}
+
+// Cabecera PLY (con normales por vértice si 'normals'); devuelve las
+// posiciones de los dos contadores
+static std::string plyHeader(uint64_t vertices, uint64_t faces, size_t &vertexOffset, size_t &faceOffset,
+                             bool normals = false)
+{
+    std::string header = "ply\nformat binary_little_endian 1.0\ncomment Marching Cubes isosurface\nelement vertex ";
+    vertexOffset = header.size();
+    header += plyCount(vertices);
+    header += "\nproperty float x\nproperty float y\nproperty float z";
+    if (normals)
+    {
+        header += "\nproperty float nx\nproperty float ny\nproperty float nz";
+    }
+    header += "\nelement face ";
+    faceOffset = header.size();
+    header += plyCount(faces);
+    header += "\nproperty list uchar int vertex_indices\nend_header\n";
+    return header;
+}
+
+bool BinaryPlySink::open(const std::string &filename, size_t bufferBytes, bool writerThread)
+{
+    total = 0;
+    if (!out.open(filename, bufferBytes, writerThread))
+    {
+        return false;
+    }
+
+    std::string header = plyHeader(0, 0, vertexCountOffset, faceCountOffset);
+    out.write(header.data(), header.size());
+    return true;
+}
+
+void BinaryPlySink::addTriangles(const Triangle *triangles, size_t count)
+{
+    // Triangle son 9 floats contiguos: x, y, z de cada vértice
+    static_assert(sizeof(Triangle) == 9 * sizeof(float), "Triangle debe ser 9 floats contiguos");
+    out.write(triangles, count * sizeof(Triangle));
+    total += count;
+}
+
+bool BinaryPlySink::finish()
+{
+    if (!out.isOpen())
+    {
+        return false;
+    }
+    if (total * 3 > static_cast<uint64_t>(INT32_MAX))
+    {
+        std::cerr << "Error: demasiados vértices para índices int de PLY." << std::endl;
+        out.close();
+        return false;
+    }
+
+    // Caras: la cara i usa los vértices 3i, 3i+1, 3i+2
+    char face[13];
+    face[0] = 3;
+    for (uint64_t i = 0; i < total; i++)
+    {
+        int32_t indices[3] = {static_cast<int32_t>(3 * i), static_cast<int32_t>(3 * i + 1), static_cast<int32_t>(3 * i + 2)};
+        std::memcpy(face + 1, indices, sizeof(indices));
+        out.write(face, sizeof(face));
+    }
+
+    std::string vertices = plyCount(total * 3);
+    std::string faces = plyCount(total);
+    bool ok = out.writeAt(vertexCountOffset, vertices.data(), vertices.size()) &&
+              out.writeAt(faceCountOffset, faces.data(), faces.size());
+    return out.close() && ok;
+}
+
+// Guarda una malla indexada como PLY binario
+bool saveIndexedMeshPly(const IndexedMesh &mesh, const std::string &filename)
+{
+    BufferedFileWriter out;
+    if (!out.open(filename, 8 << 20, false))
+    {
+        return false;
+    }
+
+    const bool normals = mesh.hasNormals();
+    size_t vertexOffset, faceOffset;
+    std::string header = plyHeader(mesh.vertices.size(), mesh.triangleCount(), vertexOffset, faceOffset, normals);
+    out.write(header.data(), header.size());
+
+    static_assert(sizeof(Vertex) == 3 * sizeof(float), "Vertex debe ser 3 floats contiguos");
+    if (normals)
+    {
+        // Posición y normal intercaladas
+        for (size_t i = 0; i < mesh.vertices.size(); i++)
+        {
+            out.write(&mesh.vertices[i], sizeof(Vertex));
+            out.write(&mesh.normals[i], sizeof(Vertex));
+        }
+    }
+    else
+    {
+        out.write(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+    }
+
+    char face[13];
+    face[0] = 3;
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        int32_t indices[3] = {static_cast<int32_t>(mesh.indices[i]),
+                              static_cast<int32_t>(mesh.indices[i + 1]),
+                              static_cast<int32_t>(mesh.indices[i + 2])};
+        std::memcpy(face + 1, indices, sizeof(indices));
+        out.write(face, sizeof(face));
+    }
+
+    return out.close();
+}
@@ -0,0 +1,164 @@
+#ifndef MESH_SINK_H
+#define MESH_SINK_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "marching_cube_serial.h"
+
+// Destino de los triángulos generados por los motores de extracción.
+// Los motores entregan bloques de triángulos consecutivos y nunca llaman a
+// addTriangles desde dos hilos a la vez, por lo que las implementaciones no
+// necesitan sincronización propia.
+class MeshSink
+{
+public:
+    virtual ~MeshSink() {}
+
+    // Recibe 'count' triángulos
+    virtual void addTriangles(const Triangle *triangles, size_t count) = 0;
+
+    // Termina la salida (vaciado de buffers, cabeceras). Devuelve false si
+    // hubo algún error
+    virtual bool finish() { return true; }
+};
+
+// Acumula los triángulos en un vector (comportamiento clásico)
+class VectorMeshSink : public MeshSink
+{
+public:
+    explicit VectorMeshSink(std::vector<Triangle> &out) : triangles(out) {}
+
+    void addTriangles(const Triangle *data, size_t count) override
+    {
+        triangles.insert(triangles.end(), data, data + count);
+    }
+
+private:
+    std::vector<Triangle> &triangles;
+};
+
+// Solo cuenta los triángulos (útil para medir sin coste de salida)
+class CountingMeshSink : public MeshSink
+{
+public:
+    CountingMeshSink() : total(0) {}
+
+    void addTriangles(const Triangle *, size_t count) override { total += count; }
+
+    size_t count() const { return total; }
+
+private:
+    size_t total;
+};
+
+// Escritura secuencial a archivo a través de buffers grandes. Opcionalmente
+// un hilo escritor vacía los buffers llenos mientras se llena el siguiente,
+// de modo que la E/S se solapa con la extracción
+class BufferedFileWriter
+{
+public:
+    BufferedFileWriter();
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter &) = delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+    // Crea (o trunca) el archivo
+    bool open(const std::string &filename, size_t bufferBytes, bool writerThread);
+
+    // Añade bytes al final del archivo
+    void write(const void *data, size_t bytes)
+    {
+        if (current.size() + bytes > capacity)
+        {
+            writeSlow(data, bytes);
+            return;
+        }
+        current.insert(current.end(), static_cast<const char *>(data), static_cast<const char *>(data) + bytes);
+    }
+
+    // Escribe todo lo pendiente y espera al hilo escritor
+    bool flush();
+
+    // Sobrescribe bytes ya escritos (p. ej. contadores de la cabecera)
+    bool writeAt(uint64_t offset, const void *data, size_t bytes);
+
+    // flush + cierre. Devuelve false si hubo algún error de escritura
+    bool close();
+
+    bool isOpen() const { return fd >= 0; }
+    bool failed() const { return error.load(); }
+
+private:
+    // Entrega el buffer actual al hilo escritor (o lo escribe directamente)
+    void submit();
+    void writeSlow(const void *data, size_t bytes);
+    void writerLoop();
+    void writeAll(const char *data, size_t bytes);
+
+    int fd;
+    size_t capacity;
+    std::vector<char> current;
+    std::atomic<bool> error;
+
+    // Estado del hilo escritor
+    bool threaded;
+    bool stopping;
+    size_t busy;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::vector<char>> pending;
+    std::vector<std::vector<char>> spare;
+};
+
+// STL binario: cabecera de 80 bytes, número de triángulos (uint32) y 50
+// bytes por triángulo (normal, 3 vértices, atributo). El número de
+// triángulos se completa en finish()
+class BinaryStlSink : public MeshSink
+{
+public:
+    bool open(const std::string &filename, size_t bufferBytes = 8 << 20, bool writerThread = false);
+
+    void addTriangles(const Triangle *triangles, size_t count) override;
+    bool finish() override;
+
+    uint64_t count() const { return total; }
+
+private:
+    BufferedFileWriter out;
+    uint64_t total = 0;
+};
+
+// PLY binario (little endian): los vértices de cada triángulo se escriben a
+// medida que llegan y la lista de caras, que solo depende del número de
+// triángulos, se añade en finish() junto con los contadores de la cabecera
+class BinaryPlySink : public MeshSink
+{
+public:
+    bool open(const std::string &filename, size_t bufferBytes = 8 << 20, bool writerThread = false);
+
+    void addTriangles(const Triangle *triangles, size_t count) override;
+    bool finish() override;
+
+    uint64_t count() const { return total; }
+
+private:
+    BufferedFileWriter out;
+    uint64_t total = 0;
+    size_t vertexCountOffset = 0;
+    size_t faceCountOffset = 0;
+};
+
+// Guarda una malla indexada como PLY binario (con nx, ny, nz por vértice si
+// la malla tiene normales)
+bool saveIndexedMeshPly(const IndexedMesh &mesh, const std::string &filename);
+
+#endif // MESH_SINK_H
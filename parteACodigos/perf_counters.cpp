@@ -0,0 +1,202 @@
+#include "perf_counters.h"
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &other)
+{
+    cycles += other.cycles;
+    instructions += other.instructions;
+    llcMisses += other.llcMisses;
+    branchMisses += other.branchMisses;
+    return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts &other) const
+{
+    PerfCounts diff;
+    diff.cycles = cycles - other.cycles;
+    diff.instructions = instructions - other.instructions;
+    diff.llcMisses = llcMisses - other.llcMisses;
+    diff.branchMisses = branchMisses - other.branchMisses;
+    return diff;
+}
+
+PerfCounterGroup::PerfCounterGroup()
+{
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+        fds[i] = -1;
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup()
+{
+    close();
+}
+
+#ifdef __linux__
+// Abre un contador del hilo actual, solo en espacio de usuario
+static int openCounter(uint64_t config)
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+// Abre y activa los contadores
+bool PerfCounterGroup::open()
+{
+    close();
+
+#ifdef __linux__
+    // PERF_COUNT_HW_CACHE_MISSES corresponde a los fallos del último nivel
+    // de caché en las CPU habituales
+    static const uint64_t configs[NUM_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+        fds[i] = openCounter(configs[i]);
+    }
+#endif
+
+    return isOpen();
+}
+
+void PerfCounterGroup::close()
+{
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+#ifdef __linux__
+        if (fds[i] >= 0)
+        {
+            ::close(fds[i]);
+        }
+#endif
+        fds[i] = -1;
+    }
+}
+
+bool PerfCounterGroup::isOpen() const
+{
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+        if (fds[i] >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Valores acumulados, escalados por el tiempo efectivo de conteo
+PerfCounts PerfCounterGroup::read() const
+{
+    double values[NUM_COUNTERS] = {0, 0, 0, 0};
+
+#ifdef __linux__
+    for (int i = 0; i < NUM_COUNTERS; i++)
+    {
+        if (fds[i] < 0)
+        {
+            continue;
+        }
+
+        // valor, tiempo activado, tiempo contando
+        uint64_t data[3];
+        if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+        values[i] = static_cast<double>(data[0]) * data[1] / data[2];
+    }
+#endif
+
+    PerfCounts counts;
+    counts.cycles = values[CYCLES];
+    counts.instructions = values[INSTRUCTIONS];
+    counts.llcMisses = values[LLC_MISSES];
+    counts.branchMisses = values[BRANCH_MISSES];
+    return counts;
+}
+
+const char *phaseName(ExtractionPhase phase)
+{
+    switch (phase)
+    {
+    case ExtractionPhase::CLASSIFICATION:
+        return "classification";
+    case ExtractionPhase::INTERPOLATION:
+        return "interpolation";
+    case ExtractionPhase::EMISSION:
+        return "emission";
+    case ExtractionPhase::MERGE:
+        return "merge";
+    }
+    return "unknown";
+}
+
+PhaseProfiler::PhaseProfiler() : current(-1)
+{
+    reset();
+}
+
+void PhaseProfiler::reset()
+{
+    for (int i = 0; i < NUM_EXTRACTION_PHASES; i++)
+    {
+        totals[i] = PerfCounts();
+        elapsedMs[i] = 0.0;
+    }
+    current = -1;
+}
+
+// Abre una fase (cerrando la anterior si la hubiera)
+void PhaseProfiler::begin(ExtractionPhase phase)
+{
+    if (current >= 0)
+    {
+        end();
+    }
+    current = static_cast<int>(phase);
+    startTime = std::chrono::steady_clock::now();
+    if (counters.isOpen())
+    {
+        startCounts = counters.read();
+    }
+}
+
+// Cierra la fase abierta y acumula su coste
+void PhaseProfiler::end()
+{
+    if (current < 0)
+    {
+        return;
+    }
+    if (counters.isOpen())
+    {
+        totals[current] += counters.read() - startCounts;
+    }
+    elapsedMs[current] += std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - startTime)
+                              .count();
+    current = -1;
+}
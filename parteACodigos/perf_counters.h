@@ -0,0 +1,137 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <chrono>
+
+// Contadores de hardware de un intervalo (solo espacio de usuario, hilo
+// que llama). Los contadores que el sistema no ofrece quedan marcados como
+// no disponibles en PerfCounterGroup::isAvailable
+struct PerfCounts
+{
+    double cycles;
+    double instructions;
+    double llcMisses;
+    double branchMisses;
+
+    PerfCounts() : cycles(0), instructions(0), llcMisses(0), branchMisses(0) {}
+
+    // Instrucciones por ciclo
+    double ipc() const { return cycles > 0 ? instructions / cycles : 0.0; }
+
+    PerfCounts &operator+=(const PerfCounts &other);
+    PerfCounts operator-(const PerfCounts &other) const;
+};
+
+// Contadores de hardware vía perf_event_open (Linux) para el hilo que llama.
+// Si el núcleo no los permite (perf_event_paranoid, máquinas virtuales,
+// otros sistemas) open devuelve false y las lecturas quedan a cero
+class PerfCounterGroup
+{
+public:
+    enum Counter
+    {
+        CYCLES,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NUM_COUNTERS
+    };
+
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup &) = delete;
+    PerfCounterGroup &operator=(const PerfCounterGroup &) = delete;
+
+    // Abre y activa los contadores. Devuelve true si hay al menos uno
+    bool open();
+    void close();
+
+    bool isOpen() const;
+    bool isAvailable(Counter counter) const { return fds[counter] >= 0; }
+
+    // Valores acumulados desde open, escalados si el núcleo multiplexa
+    PerfCounts read() const;
+
+private:
+    int fds[NUM_COUNTERS];
+};
+
+// Fases de la extracción medidas por separado
+enum class ExtractionPhase
+{
+    CLASSIFICATION, // índice de configuración de cada cubo
+    INTERPOLATION,  // cruces de la isosuperficie en las aristas
+    EMISSION,       // ensamblado de triángulos en la salida
+    MERGE           // fusión de los buffers de los hilos
+};
+
+const int NUM_EXTRACTION_PHASES = 4;
+
+// Nombre legible de una fase
+const char *phaseName(ExtractionPhase phase);
+
+// Acumula tiempo y contadores de hardware por fase. Las fases se abren y
+// cierran con begin/end (o ScopedPhase) desde un único hilo; el coste de
+// cada cambio es una lectura de los contadores, por lo que conviene
+// instrumentar tramos gruesos (una capa de cubos, no un cubo)
+class PhaseProfiler
+{
+public:
+    PhaseProfiler();
+
+    // Abre los contadores de hardware del hilo actual; sin ellos el
+    // perfilador solo mide tiempos. Devuelve true si hay contadores
+    bool open() { return counters.open(); }
+    bool hasCounters() const { return counters.isOpen(); }
+    bool isAvailable(PerfCounterGroup::Counter counter) const { return counters.isAvailable(counter); }
+
+    // Pone a cero los acumulados
+    void reset();
+
+    void begin(ExtractionPhase phase);
+    void end();
+
+    // Acumulados de una fase
+    const PerfCounts &counts(ExtractionPhase phase) const { return totals[static_cast<int>(phase)]; }
+    double milliseconds(ExtractionPhase phase) const { return elapsedMs[static_cast<int>(phase)]; }
+
+private:
+    PerfCounterGroup counters;
+    PerfCounts totals[NUM_EXTRACTION_PHASES];
+    double elapsedMs[NUM_EXTRACTION_PHASES];
+
+    // Fase abierta (-1 si ninguna) y su instante de inicio
+    int current;
+    PerfCounts startCounts;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+// Mide una fase durante la vida del objeto; no hace nada si profiler es nulo
+class ScopedPhase
+{
+public:
+    ScopedPhase(PhaseProfiler *p, ExtractionPhase phase) : profiler(p)
+    {
+        if (profiler)
+        {
+            profiler->begin(phase);
+        }
+    }
+
+    ~ScopedPhase()
+    {
+        if (profiler)
+        {
+            profiler->end();
+        }
+    }
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+private:
+    PhaseProfiler *profiler;
+};
+
+#endif // PERF_COUNTERS_H
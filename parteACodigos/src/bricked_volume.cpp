@@ -0,0 +1,390 @@
+#include "bricked_volume.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(BrickedFileHeader) == 32, "cabecera v2 con relleno inesperado");
+static_assert(sizeof(BrickEntry) == 24, "entrada del índice con relleno inesperado");
+
+// Número de bricks para 'cells' celdas
+static int brickCount(int size, int brickSize)
+{
+    return size > 1 ? (size - 1 + brickSize - 1) / brickSize : 0;
+}
+
+// Bytes de la cabecera y del índice: los datos empiezan a continuación
+static uint64_t dataStart(uint32_t numBricks)
+{
+    return sizeof(BrickedFileHeader) + static_cast<uint64_t>(numBricks) * sizeof(BrickEntry);
+}
+
+// pread/pwrite completos
+static bool preadAll(int fd, void *dest, size_t length, uint64_t offset)
+{
+    char *out = static_cast<char *>(dest);
+    while (length > 0)
+    {
+        ssize_t got = pread(fd, out, length, static_cast<off_t>(offset));
+        if (got <= 0)
+        {
+            return false;
+        }
+        out += got;
+        offset += got;
+        length -= got;
+    }
+    return true;
+}
+
+static bool pwriteAll(int fd, const void *src, size_t length, uint64_t offset)
+{
+    const char *in = static_cast<const char *>(src);
+    while (length > 0)
+    {
+        ssize_t put = pwrite(fd, in, length, static_cast<off_t>(offset));
+        if (put <= 0)
+        {
+            return false;
+        }
+        in += put;
+        offset += put;
+        length -= put;
+    }
+    return true;
+}
+
+// Comprime: XOR con el valor anterior, 4 planos de bytes y PackBits
+void packBrick(const float *values, size_t count, std::vector<unsigned char> &out)
+{
+    // XOR con el anterior y separación en planos de bytes
+    std::vector<unsigned char> planes(count * 4);
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        uint32_t delta = bits ^ previous;
+        previous = bits;
+        for (int b = 0; b < 4; b++)
+        {
+            planes[b * count + i] = static_cast<unsigned char>(delta >> (8 * b));
+        }
+    }
+
+    // PackBits: control c < 128 -> c + 1 bytes literales; c > 128 -> el
+    // byte siguiente repetido 257 - c veces
+    out.clear();
+    const size_t n = planes.size();
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t run = 1;
+        while (i + run < n && run < 128 && planes[i + run] == planes[i])
+        {
+            run++;
+        }
+
+        if (run >= 2)
+        {
+            out.push_back(static_cast<unsigned char>(257 - run));
+            out.push_back(planes[i]);
+            i += run;
+            continue;
+        }
+
+        // Literales hasta la siguiente racha de 2 o más
+        size_t start = i;
+        while (i < n && i - start < 128 && !(i + 1 < n && planes[i + 1] == planes[i]))
+        {
+            i++;
+        }
+        if (i == start)
+        {
+            i++;
+        }
+        out.push_back(static_cast<unsigned char>(i - start - 1));
+        out.insert(out.end(), planes.begin() + start, planes.begin() + i);
+    }
+}
+
+// Descomprime un brick; devuelve false si los datos no son coherentes
+bool unpackBrick(const unsigned char *in, size_t bytes, float *values, size_t count)
+{
+    std::vector<unsigned char> planes(count * 4);
+    const size_t n = planes.size();
+    size_t pos = 0, o = 0;
+
+    while (pos < bytes && o < n)
+    {
+        unsigned char c = in[pos++];
+        if (c < 128)
+        {
+            size_t len = c + 1;
+            if (pos + len > bytes || o + len > n)
+            {
+                return false;
+            }
+            std::memcpy(&planes[o], in + pos, len);
+            pos += len;
+            o += len;
+        }
+        else if (c > 128)
+        {
+            size_t len = 257 - c;
+            if (pos >= bytes || o + len > n)
+            {
+                return false;
+            }
+            std::memset(&planes[o], in[pos++], len);
+            o += len;
+        }
+    }
+    if (o != n || pos != bytes)
+    {
+        return false;
+    }
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t delta = 0;
+        for (int b = 0; b < 4; b++)
+        {
+            delta |= static_cast<uint32_t>(planes[b * count + i]) << (8 * b);
+        }
+        uint32_t bits = delta ^ previous;
+        previous = bits;
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+    return true;
+}
+
+// Escribe el campo en formato v2, comprimiendo en paralelo una capa de
+// bricks (bz) cada vez para acotar la memoria
+bool writeBrickedVolume(const float *data, int nx, int ny, int nz,
+                        const std::string &filename, int brickSize, bool compress)
+{
+    if (!data || nx < 2 || ny < 2 || nz < 2 || brickSize < 1)
+    {
+        std::cerr << "Error: Volumen o tamaño de brick no válidos para " << filename << std::endl;
+        return false;
+    }
+
+    const int countX = brickCount(nx, brickSize);
+    const int countY = brickCount(ny, brickSize);
+    const int countZ = brickCount(nz, brickSize);
+
+    BrickedFileHeader header;
+    std::memcpy(header.magic, "MCB2", 4);
+    header.version = BRICKED_VERSION;
+    header.nx = nx;
+    header.ny = ny;
+    header.nz = nz;
+    header.brickSize = brickSize;
+    header.numBricks = static_cast<uint32_t>(countX) * countY * countZ;
+    header.reserved = 0;
+
+    int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+
+    std::vector<BrickEntry> entries(header.numBricks);
+    const int layerBricks = countX * countY;
+    std::vector<std::vector<unsigned char>> stored(layerBricks);
+    uint64_t offset = dataStart(header.numBricks);
+    bool ok = true;
+
+    for (int bz = 0; bz < countZ && ok; bz++)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+        for (int b = 0; b < layerBricks; b++)
+        {
+            int bx = b % countX;
+            int by = b / countX;
+            int x0 = bx * brickSize, y0 = by * brickSize, z0 = bz * brickSize;
+            int sx = std::min(brickSize, nx - 1 - x0) + 1;
+            int sy = std::min(brickSize, ny - 1 - y0) + 1;
+            int sz = std::min(brickSize, nz - 1 - z0) + 1;
+
+            // Copiar los vóxeles del brick y calcular su rango
+            std::vector<float> values(static_cast<size_t>(sx) * sy * sz);
+            float lo = data[(static_cast<size_t>(z0) * ny + y0) * nx + x0];
+            float hi = lo;
+            float *out = values.data();
+            for (int z = z0; z < z0 + sz; z++)
+            {
+                for (int y = y0; y < y0 + sy; y++)
+                {
+                    const float *row = data + (static_cast<size_t>(z) * ny + y) * nx + x0;
+                    for (int x = 0; x < sx; x++)
+                    {
+                        lo = std::min(lo, row[x]);
+                        hi = std::max(hi, row[x]);
+                    }
+                    out = std::copy(row, row + sx, out);
+                }
+            }
+
+            BrickEntry &entry = entries[(static_cast<size_t>(bz) * countY + by) * countX + bx];
+            entry.minValue = lo;
+            entry.maxValue = hi;
+            entry.encoding = ENCODING_RAW;
+
+            std::vector<unsigned char> &bytes = stored[b];
+            const size_t rawBytes = values.size() * sizeof(float);
+            if (compress)
+            {
+                packBrick(values.data(), values.size(), bytes);
+                if (bytes.size() < rawBytes)
+                {
+                    entry.encoding = ENCODING_PACKED;
+                }
+            }
+            if (entry.encoding == ENCODING_RAW)
+            {
+                bytes.resize(rawBytes);
+                std::memcpy(bytes.data(), values.data(), rawBytes);
+            }
+        }
+
+        // Escribir la capa en orden
+        for (int b = 0; b < layerBricks && ok; b++)
+        {
+            BrickEntry &entry = entries[static_cast<size_t>(bz) * layerBricks + b];
+            entry.offset = offset;
+            entry.storedBytes = static_cast<uint32_t>(stored[b].size());
+            ok = pwriteAll(fd, stored[b].data(), stored[b].size(), offset);
+            offset += stored[b].size();
+        }
+    }
+
+    ok = ok && pwriteAll(fd, &header, sizeof(header), 0) &&
+         pwriteAll(fd, entries.data(), entries.size() * sizeof(BrickEntry), sizeof(header));
+
+    if (::close(fd) != 0 || !ok)
+    {
+        std::cerr << "Error: Escritura fallida en " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+BrickedVolumeReader::BrickedVolumeReader()
+    : fd(-1), countX(0), countY(0), countZ(0), fileSize(0)
+{
+    std::memset(&header, 0, sizeof(header));
+}
+
+BrickedVolumeReader::~BrickedVolumeReader()
+{
+    close();
+}
+
+// Abre el archivo y carga la cabecera y el índice
+bool BrickedVolumeReader::open(const std::string &filename)
+{
+    close();
+
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 && preadAll(fd, &header, sizeof(header), 0) &&
+              std::memcmp(header.magic, "MCB2", 4) == 0 && header.version == BRICKED_VERSION &&
+              header.nx > 1 && header.ny > 1 && header.nz > 1 && header.brickSize > 0;
+    if (ok)
+    {
+        fileSize = static_cast<uint64_t>(info.st_size);
+        countX = brickCount(header.nx, header.brickSize);
+        countY = brickCount(header.ny, header.brickSize);
+        countZ = brickCount(header.nz, header.brickSize);
+        ok = header.numBricks == static_cast<uint32_t>(countX) * countY * countZ &&
+             dataStart(header.numBricks) <= fileSize;
+    }
+    if (ok)
+    {
+        entries.resize(header.numBricks);
+        ok = preadAll(fd, entries.data(), entries.size() * sizeof(BrickEntry), sizeof(header));
+        for (size_t i = 0; ok && i < entries.size(); i++)
+        {
+            ok = entries[i].offset + entries[i].storedBytes <= fileSize &&
+                 entries[i].encoding <= ENCODING_PACKED;
+        }
+    }
+
+    if (!ok)
+    {
+        std::cerr << "Error: Archivo v2 inválido " << filename << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void BrickedVolumeReader::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+    fd = -1;
+    entries.clear();
+    countX = countY = countZ = 0;
+    fileSize = 0;
+}
+
+// Primer vóxel del brick y número de vóxeles por eje
+void BrickedVolumeReader::brickExtent(int index, int &x0, int &y0, int &z0, int &sx, int &sy, int &sz) const
+{
+    const int b = header.brickSize;
+    x0 = (index % countX) * b;
+    y0 = (index / countX % countY) * b;
+    z0 = (index / countX / countY) * b;
+    sx = std::min(b, header.nx - 1 - x0) + 1;
+    sy = std::min(b, header.ny - 1 - y0) + 1;
+    sz = std::min(b, header.nz - 1 - z0) + 1;
+}
+
+// Lee y descomprime un brick
+bool BrickedVolumeReader::readBrick(int index, std::vector<float> &values) const
+{
+    int x0, y0, z0, sx, sy, sz;
+    brickExtent(index, x0, y0, z0, sx, sy, sz);
+    const size_t count = static_cast<size_t>(sx) * sy * sz;
+    const BrickEntry &e = entries[index];
+    values.resize(count);
+
+    if (e.encoding == ENCODING_RAW)
+    {
+        return e.storedBytes == count * sizeof(float) && preadAll(fd, values.data(), e.storedBytes, e.offset);
+    }
+
+    std::vector<unsigned char> bytes(e.storedBytes);
+    return preadAll(fd, bytes.data(), bytes.size(), e.offset) &&
+           unpackBrick(bytes.data(), bytes.size(), values.data(), count);
+}
+
+// Bricks cuyo rango contiene el isovalor, en el orden del archivo
+void BrickedVolumeReader::collectActiveBricks(float isoValue, std::vector<int> &bricks) const
+{
+    bricks.clear();
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].minValue < isoValue && isoValue <= entries[i].maxValue)
+        {
+            bricks.push_back(static_cast<int>(i));
+        }
+    }
+}
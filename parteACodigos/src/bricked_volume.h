@@ -0,0 +1,112 @@
+#ifndef BRICKED_VOLUME_H
+#define BRICKED_VOLUME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato v2 de volumen por bricks (extensión .mcb), alternativo al .bin
+// denso (cabecera nx, ny, nz + floats).
+//
+// Las celdas (cubos) del volumen se dividen en bricks de brickSize^3; cada
+// brick guarda los vóxeles que tocan sus celdas, es decir, hasta
+// (brickSize + 1)^3 valores con x más rápido, incluida la capa que comparte
+// con el brick siguiente. Así cada brick se puede extraer por separado.
+//
+// Estructura del archivo (little-endian):
+//   BrickedFileHeader
+//   BrickEntry[numBricks]   índice en orden bx más rápido, luego by, luego bz
+//   datos de los bricks     en el mismo orden
+//
+// Un brick se almacena en crudo o comprimido sin pérdida (ENCODING_PACKED):
+// XOR de cada valor con el anterior (los bits de valores cercanos coinciden
+// en su parte alta), separación de los 4 bytes de cada valor en 4 planos y
+// codificación de rachas PackBits. Si la compresión no reduce el tamaño el
+// brick se guarda en crudo.
+struct BrickedFileHeader
+{
+    char magic[4]; // "MCB2"
+    uint32_t version;
+    int32_t nx, ny, nz;
+    int32_t brickSize;
+    uint32_t numBricks;
+    uint32_t reserved;
+};
+
+struct BrickEntry
+{
+    uint64_t offset;      // posición de los datos en el archivo
+    uint32_t storedBytes; // bytes almacenados
+    uint32_t encoding;    // ENCODING_RAW o ENCODING_PACKED
+    float minValue;       // rango de los valores del brick
+    float maxValue;
+};
+
+static const uint32_t BRICKED_VERSION = 2;
+static const uint32_t ENCODING_RAW = 0;
+static const uint32_t ENCODING_PACKED = 1;
+
+// Escribe un campo (orden de Volume, x más rápido) en formato v2.
+// Devuelve false si hubo algún error
+bool writeBrickedVolume(const float *data, int nx, int ny, int nz,
+                        const std::string &filename, int brickSize = 32, bool compress = true);
+
+// Comprime / descomprime los valores de un brick
+void packBrick(const float *values, size_t count, std::vector<unsigned char> &out);
+bool unpackBrick(const unsigned char *in, size_t bytes, float *values, size_t count);
+
+// Lector de archivos v2: carga la cabecera y el índice al abrir; los datos
+// de cada brick se leen bajo demanda con pread (seguro entre hilos)
+class BrickedVolumeReader
+{
+public:
+    BrickedVolumeReader();
+    ~BrickedVolumeReader();
+
+    BrickedVolumeReader(const BrickedVolumeReader &) = delete;
+    BrickedVolumeReader &operator=(const BrickedVolumeReader &) = delete;
+
+    // Abre el archivo y valida cabecera e índice
+    bool open(const std::string &filename);
+    void close();
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Dimensiones del volumen
+    int nx() const { return header.nx; }
+    int ny() const { return header.ny; }
+    int nz() const { return header.nz; }
+
+    // Lado del brick en celdas y número de bricks por eje
+    int getBrickSize() const { return header.brickSize; }
+    int bricksX() const { return countX; }
+    int bricksY() const { return countY; }
+    int bricksZ() const { return countZ; }
+    int numBricks() const { return static_cast<int>(entries.size()); }
+
+    int brickIndex(int bx, int by, int bz) const { return (bz * countY + by) * countX + bx; }
+    const BrickEntry &entry(int index) const { return entries[index]; }
+
+    // Primer vóxel del brick y número de vóxeles por eje
+    void brickExtent(int index, int &x0, int &y0, int &z0, int &sx, int &sy, int &sz) const;
+
+    // Lee y descomprime un brick en 'values' (sx*sy*sz valores, x más rápido)
+    bool readBrick(int index, std::vector<float> &values) const;
+
+    // Índices de los bricks cuyo rango contiene isoValue (min < iso <= max),
+    // en el orden del archivo
+    void collectActiveBricks(float isoValue, std::vector<int> &bricks) const;
+
+    // Tamaño total del archivo
+    uint64_t fileBytes() const { return fileSize; }
+
+private:
+    int fd;
+    BrickedFileHeader header;
+    std::vector<BrickEntry> entries;
+    int countX, countY, countZ;
+    uint64_t fileSize;
+};
+
+#endif // BRICKED_VOLUME_H
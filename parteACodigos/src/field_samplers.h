@@ -0,0 +1,319 @@
+#ifndef FIELD_SAMPLERS_H
+#define FIELD_SAMPLERS_H
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "generate_data.h"
+
+// Campos implícitos: functores que devuelven el valor del campo en la
+// posición (x, y, z) de la malla (en unidades de vóxel). Son tipos concretos
+// para que los motores plantilla (marching_cube_implicit.h) puedan expandirlos
+// en línea en el bucle de muestreo. Cada uno reproduce la forma del FieldType
+// correspondiente de generate_data.h.
+
+// Distancia con signo a una esfera (negativa dentro)
+struct SphereSampler
+{
+    float radius;
+    float center_x, center_y, center_z;
+
+    SphereSampler(float r = 1.0f, float cx = 0.0f, float cy = 0.0f, float cz = 0.0f)
+        : radius(r), center_x(cx), center_y(cy), center_z(cz) {}
+
+    float operator()(float x, float y, float z) const
+    {
+        float dx = x - center_x;
+        float dy = y - center_y;
+        float dz = z - center_z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz) - radius;
+    }
+};
+
+// Ondas 3D: amplitude * (sin(f·x)·cos(f·y) + cos(f·y)·sin(f·z))
+struct WavesSampler
+{
+    float frequency;
+    float amplitude;
+
+    WavesSampler(float f = 0.08f, float a = 10.0f) : frequency(f), amplitude(a) {}
+
+    float operator()(float x, float y, float z) const
+    {
+        float wave_x = std::sin(frequency * x);
+        float wave_y = std::cos(frequency * y);
+        float wave_z = std::sin(frequency * z);
+        return amplitude * (wave_x * wave_y + wave_y * wave_z);
+    }
+};
+
+// Distancia con signo a un toroide con eje paralelo a z
+struct TorusSampler
+{
+    float major_radius;
+    float minor_radius;
+    float center_x, center_y, center_z;
+
+    TorusSampler(float R = 2.0f, float r = 1.0f, float cx = 0.0f, float cy = 0.0f, float cz = 0.0f)
+        : major_radius(R), minor_radius(r), center_x(cx), center_y(cy), center_z(cz) {}
+
+    float operator()(float x, float y, float z) const
+    {
+        float dx = x - center_x;
+        float dy = y - center_y;
+        float dz = z - center_z;
+        float ring = std::sqrt(dx * dx + dy * dy) - major_radius;
+        return std::sqrt(ring * ring + dz * dz) - minor_radius;
+    }
+};
+
+// Unión de varias esferas (mínimo de sus distancias)
+struct MultipleSpheresSampler
+{
+    std::vector<SphereSampler> spheres;
+
+    float operator()(float x, float y, float z) const
+    {
+        float value = spheres.empty() ? 1.0f : spheres[0](x, y, z);
+        for (size_t i = 1; i < spheres.size(); ++i)
+        {
+            value = std::min(value, spheres[i](x, y, z));
+        }
+        return value;
+    }
+};
+
+// Esfera y toroide unidos y perturbados por ondas
+struct CombinedSampler
+{
+    SphereSampler sphere;
+    TorusSampler torus;
+    WavesSampler waves;
+
+    float operator()(float x, float y, float z) const
+    {
+        return std::min(sphere(x, y, z), torus(x, y, z)) + waves(x, y, z);
+    }
+};
+
+// Metabolas: 1 - Σ r²/d². La superficie (valor 0) rodea las bolas y se
+// fusiona donde están próximas; negativo dentro, como las esferas
+struct MetaballsSampler
+{
+    struct Ball
+    {
+        float x, y, z, radius2;
+    };
+    std::vector<Ball> balls;
+
+    // 'count' bolas de radio medio 'radius' en la caja [0, sx) x [0, sy) x [0, sz).
+    // Con probabilidad 'clustering' cada bola se coloca cerca de uno de unos
+    // pocos centros; si no, en una posición uniforme
+    MetaballsSampler(int count = 0, float radius = 1.0f, float clustering = 0.0f,
+                     float sx = 1.0f, float sy = 1.0f, float sz = 1.0f, unsigned seed = 42)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        const int numClusters = std::max(1, count / 16);
+        std::vector<Ball> clusters(numClusters);
+        for (Ball &c : clusters)
+        {
+            c = {sx * (0.2f + 0.6f * unit(rng)), sy * (0.2f + 0.6f * unit(rng)),
+                 sz * (0.2f + 0.6f * unit(rng)), 0.0f};
+        }
+        std::normal_distribution<float> spread(0.0f, 0.05f * std::min(sx, std::min(sy, sz)));
+
+        for (int i = 0; i < count; ++i)
+        {
+            Ball b;
+            if (unit(rng) < clustering)
+            {
+                const Ball &c = clusters[rng() % numClusters];
+                b.x = c.x + spread(rng);
+                b.y = c.y + spread(rng);
+                b.z = c.z + spread(rng);
+            }
+            else
+            {
+                b.x = sx * unit(rng);
+                b.y = sy * unit(rng);
+                b.z = sz * unit(rng);
+            }
+            float r = radius * (0.5f + unit(rng));
+            b.radius2 = r * r;
+            balls.push_back(b);
+        }
+    }
+
+    float operator()(float x, float y, float z) const
+    {
+        float sum = 0.0f;
+        for (const Ball &b : balls)
+        {
+            float dx = x - b.x;
+            float dy = y - b.y;
+            float dz = z - b.z;
+            sum += b.radius2 / (dx * dx + dy * dy + dz * dz + 1e-6f);
+        }
+        return 1.0f - sum;
+    }
+};
+
+// Ruido de gradiente (Perlin) con permutación derivada de la semilla.
+// Valores en [-1, 1] con media 0: la superficie de isovalor 0 ocupa una
+// fracción del volumen que crece con 'frequency' (periodos por vóxel)
+struct NoiseSampler
+{
+    std::vector<int> perm;
+    float frequency;
+
+    NoiseSampler(float f = 0.1f, unsigned seed = 42) : perm(512), frequency(f)
+    {
+        std::iota(perm.begin(), perm.begin() + 256, 0);
+        std::shuffle(perm.begin(), perm.begin() + 256, std::mt19937(seed));
+        std::copy(perm.begin(), perm.begin() + 256, perm.begin() + 256);
+    }
+
+    static float fade(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+    static float lerp(float t, float a, float b) { return a + t * (b - a); }
+
+    // Producto escalar con uno de los 12 gradientes de las aristas del cubo
+    static float grad(int hash, float x, float y, float z)
+    {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    float operator()(float x, float y, float z) const
+    {
+        x *= frequency;
+        y *= frequency;
+        z *= frequency;
+
+        float fx = std::floor(x), fy = std::floor(y), fz = std::floor(z);
+        int X = static_cast<int>(fx) & 255;
+        int Y = static_cast<int>(fy) & 255;
+        int Z = static_cast<int>(fz) & 255;
+        x -= fx;
+        y -= fy;
+        z -= fz;
+        float u = fade(x), v = fade(y), w = fade(z);
+
+        int A = perm[X] + Y, AA = perm[A] + Z, AB = perm[A + 1] + Z;
+        int B = perm[X + 1] + Y, BA = perm[B] + Z, BB = perm[B + 1] + Z;
+
+        return lerp(w, lerp(v, lerp(u, grad(perm[AA], x, y, z), grad(perm[BA], x - 1, y, z)),
+                            lerp(u, grad(perm[AB], x, y - 1, z), grad(perm[BB], x - 1, y - 1, z))),
+                    lerp(v, lerp(u, grad(perm[AA + 1], x, y, z - 1), grad(perm[BA + 1], x - 1, y, z - 1)),
+                         lerp(u, grad(perm[AB + 1], x, y - 1, z - 1), grad(perm[BB + 1], x - 1, y - 1, z - 1))));
+    }
+};
+
+// Aplica la escala y el desplazamiento de DataConfig a otro campo
+template <typename Sampler>
+struct ScaledSampler
+{
+    Sampler sampler;
+    float scale;
+    float offset;
+
+    float operator()(float x, float y, float z) const
+    {
+        return sampler(x, y, z) * scale + offset;
+    }
+};
+
+// Construye el campo descrito por 'config' y llama a func(sampler) con su
+// tipo concreto: la elección del tipo se hace una vez y el campo queda
+// expandido en línea dentro de 'func'
+template <typename Func>
+void withFieldSampler(const DataConfig &config, Func func)
+{
+    const float sx = static_cast<float>(config.size_x);
+    const float sy = static_cast<float>(config.size_y);
+    const float sz = static_cast<float>(config.size_z);
+
+    switch (config.type)
+    {
+    case FieldType::SPHERE:
+        func(ScaledSampler<SphereSampler>{
+            SphereSampler(sx * 0.25f, sx / 2.0f, sy / 2.0f, sz / 2.0f),
+            config.scale, config.offset});
+        break;
+
+    case FieldType::WAVES_3D:
+        func(ScaledSampler<WavesSampler>{WavesSampler(0.08f, 10.0f), config.scale, config.offset});
+        break;
+
+    case FieldType::MULTIPLE_SPHERES:
+    {
+        MultipleSpheresSampler spheres;
+        spheres.spheres.push_back(SphereSampler(sx * 0.18f, sx * 0.30f, sy * 0.30f, sz * 0.30f));
+        spheres.spheres.push_back(SphereSampler(sx * 0.15f, sx * 0.70f, sy * 0.35f, sz * 0.50f));
+        spheres.spheres.push_back(SphereSampler(sx * 0.12f, sx * 0.45f, sy * 0.72f, sz * 0.35f));
+        spheres.spheres.push_back(SphereSampler(sx * 0.10f, sx * 0.55f, sy * 0.55f, sz * 0.75f));
+        func(ScaledSampler<MultipleSpheresSampler>{spheres, config.scale, config.offset});
+        break;
+    }
+
+    case FieldType::TORUS:
+        func(ScaledSampler<TorusSampler>{
+            TorusSampler(sx * 0.30f, sx * 0.10f, sx / 2.0f, sy / 2.0f, sz / 2.0f),
+            config.scale, config.offset});
+        break;
+
+    case FieldType::COMBINED:
+        func(ScaledSampler<CombinedSampler>{
+            CombinedSampler{SphereSampler(sx * 0.20f, sx / 2.0f, sy / 2.0f, sz / 2.0f),
+                            TorusSampler(sx * 0.35f, sx * 0.06f, sx / 2.0f, sy / 2.0f, sz / 2.0f),
+                            WavesSampler(0.2f, 1.0f)},
+            config.scale, config.offset});
+        break;
+
+    case FieldType::METABALLS:
+        func(ScaledSampler<MetaballsSampler>{
+            MetaballsSampler(config.num_blobs, sx * config.blob_radius, config.clustering,
+                             sx, sy, sz, static_cast<unsigned>(config.seed)),
+            config.scale, config.offset});
+        break;
+
+    case FieldType::NOISE:
+        func(ScaledSampler<NoiseSampler>{
+            NoiseSampler(config.noise_frequency / sx, static_cast<unsigned>(config.seed)),
+            config.scale, config.offset});
+        break;
+    }
+}
+
+// Muestrea 'sampler' en todos los vóxeles de 'field' (ya dimensionado),
+// repartiendo los planos z entre hilos
+template <typename Sampler>
+void sampleField(Volume &field, const Sampler &sampler)
+{
+    const int nx = field.nx();
+    const int ny = field.ny();
+    const int nz = field.nz();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int z = 0; z < nz; ++z)
+    {
+        for (int y = 0; y < ny; ++y)
+        {
+            float *row = field.row(y, z);
+            for (int x = 0; x < nx; ++x)
+            {
+                row[x] = sampler(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+            }
+        }
+    }
+}
+
+#endif // FIELD_SAMPLERS_H
@@ -1,4 +1,6 @@
 #include "generate_data.h"
+#include "metrics.h"
+#include "field_samplers.h"
 #include <iostream>
 #include <fstream>
 #include <cmath>
@@ -23,8 +25,8 @@ bool checkMemoryRequirements(int nx, int ny, int nz)
     return true;
 }
 
-// Función segura para redimensionar el vector 3D
-bool resizeField(std::vector<std::vector<std::vector<float>>> &field,
+// Función segura para redimensionar el volumen 3D
+bool resizeField(Volume &field,
                  int nx, int ny, int nz)
 {
 
@@ -33,39 +35,26 @@ bool resizeField(std::vector<std::vector<std::vector<float>>> &field,
         return false;
     }
 
-    try
-    {
-        std::cout << "Redimensionando campo a " << nx << "x" << ny << "x" << nz << "..." << std::endl;
-
-        // Limpiar memoria existente
-        field.clear();
-        field.shrink_to_fit();
+    std::cout << "Redimensionando campo a " << nx << "x" << ny << "x" << nz << "..." << std::endl;
 
-        // Redimensionar paso a paso para mejor control de memoria
-        field.resize(nx);
-        for (int x = 0; x < nx; ++x)
-        {
-            field[x].resize(ny);
-            for (int y = 0; y < ny; ++y)
-            {
-                field[x][y].resize(nz, 0.0f); // Inicializar con 0
-            }
-        }
-
-        std::cout << "Redimensionamiento exitoso." << std::endl;
-        return true;
-    }
-    catch (const std::bad_alloc &e)
+    // Una única reserva alineada (libera la memoria anterior)
+    if (!field.allocate(nx, ny, nz))
     {
-        std::cerr << "Error de memoria: " << e.what() << std::endl;
+        std::cerr << "Error de memoria: no se pudieron reservar "
+                  << (static_cast<size_t>(nx) * ny * nz * sizeof(float)) / (1024 * 1024) << " MB" << std::endl;
         return false;
     }
+    field.fill(0.0f); // Inicializar con 0
+
+    std::cout << "Redimensionamiento exitoso." << std::endl;
+    return true;
 }
 
 // Función principal de generación - CORREGIDA
-void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
+void generateScalarField3D(Volume &field,
                            const DataConfig &config)
 {
+    MC_SCOPED_TIMER("field_generate");
 
     std::cout << "\n=== GENERANDO CAMPO ESCALAR 3D ===" << std::endl;
     std::cout << "Tamaño: " << config.size_x << "x" << config.size_y << "x" << config.size_z << std::endl;
@@ -88,6 +77,13 @@ void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
     case FieldType::COMBINED:
         std::cout << "COMBINADO";
         break;
+    case FieldType::METABALLS:
+        std::cout << "METABOLAS (" << config.num_blobs << ", agrupamiento " << config.clustering
+                  << ", semilla " << config.seed << ")";
+        break;
+    case FieldType::NOISE:
+        std::cout << "RUIDO (frecuencia " << config.noise_frequency << ", semilla " << config.seed << ")";
+        break;
     }
     std::cout << std::endl;
 
@@ -117,20 +113,22 @@ void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
             break;
 
         case FieldType::MULTIPLE_SPHERES:
-            // Implementación simplificada para evitar problemas
-            generateSphere(field, config.size_x, config.size_y, config.size_z,
-                           config.size_x * 0.2f, config.size_x * 0.3f,
-                           config.size_y * 0.3f, config.size_z * 0.3f);
-            break;
-
         case FieldType::TORUS:
         case FieldType::COMBINED:
-            // Por ahora usar esfera para evitar complejidad
-            generateSphere(field, config.size_x, config.size_y, config.size_z,
-                           config.size_x * 0.3f, config.size_x / 2.0f,
-                           config.size_y / 2.0f, config.size_z / 2.0f);
+        case FieldType::METABALLS:
+        case FieldType::NOISE:
+        {
+            // Mismos campos que usa la extracción implícita; la escala y el
+            // offset se aplican más abajo
+            DataConfig unscaled = config;
+            unscaled.scale = 1.0f;
+            unscaled.offset = 0.0f;
+            withFieldSampler(unscaled, [&](const auto &sampler) {
+                sampleField(field, sampler);
+            });
             break;
         }
+        }
 
         std::cout << "Contenido generado exitosamente." << std::endl;
     }
@@ -144,15 +142,16 @@ void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
     if (config.scale != 1.0f || config.offset != 0.0f)
     {
         std::cout << "Aplicando escala y offset..." << std::endl;
-        for (int x = 0; x < config.size_x; ++x)
+        float *values = field.data();
+        const long long count = static_cast<long long>(field.size());
+        const float scale = config.scale;
+        const float offset = config.offset;
+#ifdef _OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+        for (long long i = 0; i < count; ++i)
         {
-            for (int y = 0; y < config.size_y; ++y)
-            {
-                for (int z = 0; z < config.size_z; ++z)
-                {
-                    field[x][y][z] = field[x][y][z] * config.scale + config.offset;
-                }
-            }
+            values[i] = values[i] * scale + offset;
         }
     }
 
@@ -161,7 +160,9 @@ void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
 }
 
 // Esfera centrada - OPTIMIZADA
-void generateSphere(std::vector<std::vector<std::vector<float>>> &field,
+// Planos z repartidos entre hilos; en cada fila dy² + dz² es constante y el
+// bucle interno en x es vectorizable
+void generateSphere(Volume &field,
                     int nx, int ny, int nz, float radius,
                     float center_x, float center_y, float center_z)
 {
@@ -169,23 +170,27 @@ void generateSphere(std::vector<std::vector<std::vector<float>>> &field,
     std::cout << "Generando esfera: radio=" << radius
               << ", centro=(" << center_x << "," << center_y << "," << center_z << ")" << std::endl;
 
-    for (int x = 0; x < nx; ++x)
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int z = 0; z < nz; ++z)
     {
-        if (x % (nx / 4) == 0)
-        {
-            std::cout << "Progreso: " << (100 * x / nx) << "%" << std::endl;
-        }
+        float dz = z - center_z;
+        float dz2 = dz * dz;
 
         for (int y = 0; y < ny; ++y)
         {
-            for (int z = 0; z < nz; ++z)
+            float dy = y - center_y;
+            float dy2 = dy * dy;
+            float *row = field.row(y, z);
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int x = 0; x < nx; ++x)
             {
                 float dx = x - center_x;
-                float dy = y - center_y;
-                float dz = z - center_z;
-
-                float distance = sqrt(dx * dx + dy * dy + dz * dz);
-                field[x][y][z] = distance - radius;
+                row[x] = std::sqrt(dx * dx + dy2 + dz2) - radius;
             }
         }
     }
@@ -194,28 +199,46 @@ void generateSphere(std::vector<std::vector<std::vector<float>>> &field,
 }
 
 // Ondas 3D - OPTIMIZADA
-void generateWaves3D(std::vector<std::vector<std::vector<float>>> &field,
+// El campo es separable: sin(f·x), cos(f·y) y sin(f·z) se tabulan una vez
+// por eje y el bucle interno queda en productos y sumas vectorizables
+void generateWaves3D(Volume &field,
                      int nx, int ny, int nz, float frequency, float amplitude)
 {
 
     std::cout << "Generando ondas 3D: freq=" << frequency << ", amp=" << amplitude << std::endl;
 
+    std::vector<float> wave_x(nx), wave_y(ny), wave_z(nz);
     for (int x = 0; x < nx; ++x)
     {
-        if (x % (nx / 4) == 0)
-        {
-            std::cout << "Progreso ondas: " << (100 * x / nx) << "%" << std::endl;
-        }
+        wave_x[x] = sin(frequency * x);
+    }
+    for (int y = 0; y < ny; ++y)
+    {
+        wave_y[y] = cos(frequency * y);
+    }
+    for (int z = 0; z < nz; ++z)
+    {
+        wave_z[z] = sin(frequency * z);
+    }
+    const float *sin_x = wave_x.data();
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int z = 0; z < nz; ++z)
+    {
         for (int y = 0; y < ny; ++y)
         {
-            for (int z = 0; z < nz; ++z)
+            const float wy = wave_y[y];
+            const float wyz = wy * wave_z[z];
+            float *row = field.row(y, z);
+
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int x = 0; x < nx; ++x)
             {
-                float wave_x = sin(frequency * x);
-                float wave_y = cos(frequency * y);
-                float wave_z = sin(frequency * z);
-
-                field[x][y][z] = amplitude * (wave_x * wave_y + wave_y * wave_z);
+                row[x] = amplitude * (sin_x[x] * wy + wyz);
             }
         }
     }
@@ -224,151 +247,91 @@ void generateWaves3D(std::vector<std::vector<std::vector<float>>> &field,
 }
 
 // Guardar en formato binario - MEJORADO
-bool saveFieldBinary(const std::vector<std::vector<std::vector<float>>> &field,
-                     const std::string &filename)
+// Escritura masiva con pwrite de bloques grandes en paralelo (volume_io.h)
+bool saveFieldBinary(const Volume &field,
+                     const std::string &filename,
+                     const VolumeIOOptions &options)
 {
+    MC_SCOPED_TIMER("field_save");
 
     std::cout << "Guardando campo en: " << filename << "..." << std::endl;
 
-    std::ofstream file(filename, std::ios::binary);
-    if (!file.is_open())
+    if (!writeVolumeFile(field, filename, options))
     {
-        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
         return false;
     }
-
-    int nx = field.size();
-    int ny = field[0].size();
-    int nz = field[0][0].size();
-
-    // Escribir dimensiones
-    file.write(reinterpret_cast<const char *>(&nx), sizeof(int));
-    file.write(reinterpret_cast<const char *>(&ny), sizeof(int));
-    file.write(reinterpret_cast<const char *>(&nz), sizeof(int));
-
-    // Escribir datos con verificación de progreso
-    int total_planes = nx;
-    for (int x = 0; x < nx; ++x)
-    {
-        if (x % (nx / 4) == 0)
-        {
-            std::cout << "Guardando: " << (100 * x / nx) << "%" << std::endl;
-        }
-
-        for (int y = 0; y < ny; ++y)
-        {
-            for (int z = 0; z < nz; ++z)
-            {
-                file.write(reinterpret_cast<const char *>(&field[x][y][z]), sizeof(float));
-            }
-        }
-    }
-
-    file.close();
+    MC_METRIC_ADD(BYTES_WRITTEN, sizeof(int) * 3 + field.bytes());
 
     // Verificar tamaño del archivo
-    std::ifstream check(filename, std::ios::binary | std::ios::ate);
-    if (check.is_open())
+    int nx, ny, nz;
+    if (!readVolumeHeader(filename, nx, ny, nz) ||
+        nx != field.nx() || ny != field.ny() || nz != field.nz())
     {
-        size_t file_size = check.tellg();
-        size_t expected_size = sizeof(int) * 3 + sizeof(float) * nx * ny * nz;
-        check.close();
-
-        if (file_size == expected_size)
-        {
-            std::cout << "Archivo guardado exitosamente: " << filename
-                      << " (" << (file_size / 1024 / 1024) << " MB)" << std::endl;
-            return true;
-        }
-        else
-        {
-            std::cerr << "Error: Tamaño de archivo incorrecto" << std::endl;
-            return false;
-        }
+        std::cerr << "Error: Tamaño de archivo incorrecto" << std::endl;
+        return false;
     }
 
-    return false;
+    std::cout << "Archivo guardado exitosamente: " << filename
+              << " (" << ((sizeof(int) * 3 + field.bytes()) / 1024 / 1024) << " MB)" << std::endl;
+    return true;
 }
 
 // Cargar desde formato binario - MEJORADO
-bool loadFieldBinary(std::vector<std::vector<std::vector<float>>> &field,
-                     const std::string &filename, int &nx, int &ny, int &nz)
+// Lectura masiva con pread de bloques grandes en paralelo (volume_io.h)
+bool loadFieldBinary(Volume &field,
+                     const std::string &filename, int &nx, int &ny, int &nz,
+                     const VolumeIOOptions &options)
 {
+    MC_SCOPED_TIMER("field_load");
 
     std::cout << "Cargando campo desde: " << filename << "..." << std::endl;
 
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open())
+    // Leer dimensiones (y validar el tamaño del archivo)
+    if (!readVolumeHeader(filename, nx, ny, nz))
     {
-        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
         return false;
     }
 
-    // Leer dimensiones
-    file.read(reinterpret_cast<char *>(&nx), sizeof(int));
-    file.read(reinterpret_cast<char *>(&ny), sizeof(int));
-    file.read(reinterpret_cast<char *>(&nz), sizeof(int));
-
     std::cout << "Dimensiones del archivo: " << nx << "x" << ny << "x" << nz << std::endl;
 
-    // Redimensionar de forma segura
-    if (!resizeField(field, nx, ny, nz))
+    if (!checkMemoryRequirements(nx, ny, nz) || !readVolumeFile(field, filename, options))
     {
-        file.close();
         return false;
     }
 
-    // Leer datos
-    for (int x = 0; x < nx; ++x)
-    {
-        for (int y = 0; y < ny; ++y)
-        {
-            for (int z = 0; z < nz; ++z)
-            {
-                file.read(reinterpret_cast<char *>(&field[x][y][z]), sizeof(float));
-            }
-        }
-    }
-
-    file.close();
+    MC_METRIC_ADD(BYTES_READ, sizeof(int) * 3 + field.bytes());
     std::cout << "Campo cargado exitosamente." << std::endl;
     return true;
 }
 
 // Imprimir información del dataset - MEJORADO
-void printDatasetInfo(const std::vector<std::vector<std::vector<float>>> &field,
+void printDatasetInfo(const Volume &field,
                       const std::string &name)
 {
 
-    if (field.empty() || field[0].empty() || field[0][0].empty())
+    if (field.empty())
     {
         std::cerr << "Error: Campo vacío" << std::endl;
         return;
     }
 
-    int nx = field.size();
-    int ny = field[0].size();
-    int nz = field[0][0].size();
+    int nx = field.nx();
+    int ny = field.ny();
+    int nz = field.nz();
 
-    float min_val = field[0][0][0];
-    float max_val = field[0][0][0];
+    const float *values = field.data();
+    float min_val = values[0];
+    float max_val = values[0];
     double sum = 0.0;
-    int count = 0;
+    size_t count = field.size();
 
-    // Calcular estadísticas
-    for (int x = 0; x < nx; ++x)
+    // Calcular estadísticas en un único recorrido lineal
+    for (size_t i = 0; i < count; ++i)
     {
-        for (int y = 0; y < ny; ++y)
-        {
-            for (int z = 0; z < nz; ++z)
-            {
-                float val = field[x][y][z];
-                min_val = std::min(min_val, val);
-                max_val = std::max(max_val, val);
-                sum += val;
-                count++;
-            }
-        }
+        float val = values[i];
+        min_val = std::min(min_val, val);
+        max_val = std::max(max_val, val);
+        sum += val;
     }
 
     float avg_val = sum / count;
@@ -388,7 +351,8 @@ void generateTestDatasets()
 {
     std::cout << "\n=== GENERANDO DATASETS DE PRUEBA SEGUROS ===" << std::endl;
 
-    std::vector<std::vector<std::vector<float>>> field;
+    // Se reutiliza el mismo volumen: cada dataset es una única reserva
+    Volume field;
 
     // Dataset 1: Esfera pequeña 32x32x32 (para debug)
     std::cout << "\n--- DATASET 1: ESFERA 32³ ---" << std::endl;
@@ -424,4 +388,47 @@ void generateTestDatasets()
     std::cout << "- test_sphere_48.bin (mediano, test básico)" << std::endl;
     std::cout << "- test_waves_48.bin (mediano, patrones complejos)" << std::endl;
     std::cout << "- test_sphere_64.bin (grande, test de rendimiento)" << std::endl;
+}
+
+// Generar la familia de datasets de estrés
+void generateStressDatasets(int size)
+{
+    std::cout << "\n=== GENERANDO DATASETS DE ESTRÉS " << size << "³ ===" << std::endl;
+
+    struct StressCase
+    {
+        const char *name;
+        FieldType type;
+        int num_blobs;
+        float blob_radius;
+        float clustering;
+        float noise_frequency;
+    };
+
+    // De menor a mayor densidad de superficie, y de uniforme a agrupado
+    const StressCase cases[] = {
+        {"torus", FieldType::TORUS, 0, 0.0f, 0.0f, 0.0f},
+        {"spheres", FieldType::MULTIPLE_SPHERES, 0, 0.0f, 0.0f, 0.0f},
+        {"combined", FieldType::COMBINED, 0, 0.0f, 0.0f, 0.0f},
+        {"metaballs_sparse", FieldType::METABALLS, 8, 0.05f, 0.0f, 0.0f},
+        {"metaballs_uniform", FieldType::METABALLS, 128, 0.04f, 0.0f, 0.0f},
+        {"metaballs_clustered", FieldType::METABALLS, 128, 0.04f, 0.95f, 0.0f},
+        {"noise_low", FieldType::NOISE, 0, 0.0f, 0.0f, 2.0f},
+        {"noise_high", FieldType::NOISE, 0, 0.0f, 0.0f, 16.0f},
+    };
+
+    Volume field;
+    for (const StressCase &c : cases)
+    {
+        DataConfig config(size, c.type);
+        config.num_blobs = c.num_blobs;
+        config.blob_radius = c.blob_radius;
+        config.clustering = c.clustering;
+        config.noise_frequency = c.noise_frequency;
+
+        std::string filename = std::string("stress_") + c.name + "_" + std::to_string(size) + ".bin";
+        generateScalarField3D(field, config);
+        printDatasetInfo(field, filename);
+        saveFieldBinary(field, filename);
+    }
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <string>
+#include "volume.h"
+#include "volume_io.h"
 
 enum class FieldType
 {
@@ -10,7 +12,9 @@ enum class FieldType
     MULTIPLE_SPHERES,
     WAVES_3D,
     TORUS,
-    COMBINED
+    COMBINED,
+    METABALLS, // esferas suaves con semilla, uniformes o agrupadas
+    NOISE      // ruido de gradiente con semilla
 };
 
 struct DataConfig
@@ -21,33 +25,56 @@ struct DataConfig
     float offset;
     int seed;
 
+    // Parámetros de METABALLS y NOISE, que controlan la densidad de la
+    // superficie (proporción de celdas activas y número de triángulos):
+    // - num_blobs: número de metabolas
+    // - blob_radius: radio medio de cada metabola, relativo a size_x
+    // - clustering: 0 = metabolas repartidas uniformemente, 1 = todas
+    //   agrupadas alrededor de unos pocos centros
+    // - noise_frequency: periodos de ruido a lo largo de size_x (la
+    //   superficie crece aproximadamente en proporción)
+    int num_blobs;
+    float blob_radius;
+    float clustering;
+    float noise_frequency;
+
     DataConfig(int size = 64, FieldType field_type = FieldType::SPHERE)
         : size_x(size), size_y(size), size_z(size), type(field_type),
-          scale(1.0f), offset(0.0f), seed(42) {}
+          scale(1.0f), offset(0.0f), seed(42),
+          num_blobs(16), blob_radius(0.08f), clustering(0.0f), noise_frequency(4.0f) {}
 };
 
+// Todos los campos se guardan en un Volume (ver volume.h): un único bloque
+// contiguo con x como índice más rápido, igual que en los archivos .bin
+
 // Funciones principales
-void generateScalarField3D(std::vector<std::vector<std::vector<float>>> &field,
+void generateScalarField3D(Volume &field,
                            const DataConfig &config);
 
 void generateTestDatasets();
 
+// Familia de datasets de estrés de lado 'size': de superficies dispersas a
+// muy densas y de repartos uniformes a muy agrupados
+void generateStressDatasets(int size);
+
 // Funciones específicas
-void generateSphere(std::vector<std::vector<std::vector<float>>> &field,
+void generateSphere(Volume &field,
                     int nx, int ny, int nz, float radius,
                     float center_x, float center_y, float center_z);
 
-void generateWaves3D(std::vector<std::vector<std::vector<float>>> &field,
+void generateWaves3D(Volume &field,
                      int nx, int ny, int nz, float frequency, float amplitude);
 
 // Utilidades
-bool saveFieldBinary(const std::vector<std::vector<std::vector<float>>> &field,
-                     const std::string &filename);
+bool saveFieldBinary(const Volume &field,
+                     const std::string &filename,
+                     const VolumeIOOptions &options = VolumeIOOptions());
 
-bool loadFieldBinary(std::vector<std::vector<std::vector<float>>> &field,
-                     const std::string &filename, int &nx, int &ny, int &nz);
+bool loadFieldBinary(Volume &field,
+                     const std::string &filename, int &nx, int &ny, int &nz,
+                     const VolumeIOOptions &options = VolumeIOOptions());
 
-void printDatasetInfo(const std::vector<std::vector<std::vector<float>>> &field,
+void printDatasetInfo(const Volume &field,
                       const std::string &name);
 
 #endif
@@ -0,0 +1,106 @@
+#include "mapped_volume.h"
+#include "metrics.h"
+#include "volume_io.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+MappedVolume::MappedVolume()
+    : mapping(nullptr), mappingSize(0), values(nullptr), sizeX(0), sizeY(0), sizeZ(0)
+{
+}
+
+MappedVolume::~MappedVolume()
+{
+    close();
+}
+
+// Proyecta el archivo en memoria
+bool MappedVolume::open(const std::string &filename, bool sequential)
+{
+    close();
+
+    // Validar cabecera y tamaño antes de proyectar
+    int nx, ny, nz;
+    if (!readVolumeHeader(filename, nx, ny, nz))
+    {
+        return false;
+    }
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
+        return false;
+    }
+
+    size_t fileSize = VOLUME_HEADER_SIZE + static_cast<size_t>(nx) * ny * nz * sizeof(float);
+    void *ptr = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    // La proyección sigue siendo válida tras cerrar el descriptor
+    ::close(fd);
+
+    if (ptr == MAP_FAILED)
+    {
+        std::cerr << "Error: mmap falló para " << filename << std::endl;
+        return false;
+    }
+
+    if (sequential)
+    {
+        madvise(ptr, fileSize, MADV_SEQUENTIAL);
+        madvise(ptr, fileSize, MADV_WILLNEED);
+    }
+
+    // Los datos se leen bajo demanda al tocarlos, pero los recorridos usan
+    // el volumen completo: se cuenta el archivo entero como leído
+    MC_METRIC_ADD(BYTES_READ, fileSize);
+
+    mapping = ptr;
+    mappingSize = fileSize;
+    values = reinterpret_cast<const float *>(static_cast<const char *>(ptr) + VOLUME_HEADER_SIZE);
+    sizeX = nx;
+    sizeY = ny;
+    sizeZ = nz;
+    return true;
+}
+
+// Deshace la proyección
+void MappedVolume::close()
+{
+    if (mapping)
+    {
+        munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    values = nullptr;
+    sizeX = sizeY = sizeZ = 0;
+}
+
+// Pide al kernel que precargue los planos z en [zBegin, zEnd)
+void MappedVolume::prefetchSlices(int zBegin, int zEnd) const
+{
+    if (!mapping)
+    {
+        return;
+    }
+
+    zBegin = std::max(zBegin, 0);
+    zEnd = std::min(zEnd, sizeZ);
+    if (zBegin >= zEnd)
+    {
+        return;
+    }
+
+    // madvise requiere direcciones alineadas a página
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t planeBytes = static_cast<size_t>(sizeX) * sizeY * sizeof(float);
+    size_t begin = VOLUME_HEADER_SIZE + zBegin * planeBytes;
+    size_t end = VOLUME_HEADER_SIZE + zEnd * planeBytes;
+    begin -= begin % page;
+
+    madvise(static_cast<char *>(mapping) + begin, end - begin, MADV_WILLNEED);
+}
@@ -0,0 +1,52 @@
+#ifndef MAPPED_VOLUME_H
+#define MAPPED_VOLUME_H
+
+#include <cstddef>
+#include <string>
+
+// Vista de solo lectura, sin copias, de un archivo .bin escrito por
+// saveFieldBinary (cabecera de 3 int: nx, ny, nz, seguida de nx*ny*nz float
+// con x como índice más rápido). El archivo se proyecta en memoria con mmap,
+// de modo que los datos se comparten con la caché de páginas del sistema y
+// data() puede pasarse directamente a MarchingCubesSerial::setScalarField.
+class MappedVolume
+{
+public:
+    MappedVolume();
+    ~MappedVolume();
+
+    MappedVolume(const MappedVolume &) = delete;
+    MappedVolume &operator=(const MappedVolume &) = delete;
+
+    // Proyecta el archivo. Con 'sequential' se indica al kernel que se
+    // recorrerá en orden (lectura anticipada agresiva y liberación de las
+    // páginas ya leídas). Devuelve false si el archivo no es válido
+    bool open(const std::string &filename, bool sequential = true);
+
+    // Deshace la proyección
+    void close();
+
+    bool isOpen() const { return mapping != nullptr; }
+
+    // Dimensiones
+    int nx() const { return sizeX; }
+    int ny() const { return sizeY; }
+    int nz() const { return sizeZ; }
+
+    // Total de elementos
+    size_t size() const { return static_cast<size_t>(sizeX) * sizeY * sizeZ; }
+
+    // Datos (solo lectura) con el mismo orden que Volume
+    const float *data() const { return values; }
+
+    // Pide al kernel que precargue los planos z en [zBegin, zEnd)
+    void prefetchSlices(int zBegin, int zEnd) const;
+
+private:
+    void *mapping;
+    size_t mappingSize;
+    const float *values;
+    int sizeX, sizeY, sizeZ;
+};
+
+#endif // MAPPED_VOLUME_H
@@ -0,0 +1,224 @@
+#include "metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+const char *metricName(MetricCounter counter)
+{
+    switch (counter)
+    {
+    case MetricCounter::CELLS_VISITED:
+        return "cells_visited";
+    case MetricCounter::ACTIVE_CELLS:
+        return "active_cells";
+    case MetricCounter::TRIANGLES_EMITTED:
+        return "triangles_emitted";
+    case MetricCounter::BYTES_READ:
+        return "bytes_read";
+    case MetricCounter::BYTES_WRITTEN:
+        return "bytes_written";
+    }
+    return "unknown";
+}
+
+ThreadMetrics::ThreadMetrics()
+{
+    for (int i = 0; i < NUM_METRIC_COUNTERS; i++)
+    {
+        counters[i] = 0;
+    }
+}
+
+// Acumula una medición; hay pocos temporizadores distintos, así que basta
+// una búsqueda lineal por puntero (o por contenido si la cadena se repite
+// en otra unidad de traducción)
+void ThreadMetrics::addTime(const char *name, double seconds)
+{
+    for (TimerStats &timer : timers)
+    {
+        if (timer.name == name || std::strcmp(timer.name, name) == 0)
+        {
+            timer.calls++;
+            timer.totalSeconds += seconds;
+            timer.maxSeconds = std::max(timer.maxSeconds, seconds);
+            return;
+        }
+    }
+    timers.push_back({name, 1, seconds, seconds});
+}
+
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+// Métricas del hilo actual; el registro solo se toca en el primer uso
+ThreadMetrics &MetricsRegistry::local()
+{
+    thread_local ThreadMetrics *metrics = nullptr;
+    if (!metrics)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.emplace_back(new ThreadMetrics());
+        metrics = threads.back().get();
+    }
+    return *metrics;
+}
+
+void MetricsRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &thread : threads)
+    {
+        *thread = ThreadMetrics();
+    }
+}
+
+// Suma los temporizadores de todos los hilos por nombre
+static std::vector<TimerStats> mergeTimers(const std::vector<std::unique_ptr<ThreadMetrics>> &threads)
+{
+    std::vector<TimerStats> merged;
+    for (const auto &thread : threads)
+    {
+        for (const TimerStats &timer : thread->timers)
+        {
+            bool found = false;
+            for (TimerStats &m : merged)
+            {
+                if (std::strcmp(m.name, timer.name) == 0)
+                {
+                    m.calls += timer.calls;
+                    m.totalSeconds += timer.totalSeconds;
+                    m.maxSeconds = std::max(m.maxSeconds, timer.maxSeconds);
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                merged.push_back(timer);
+            }
+        }
+    }
+    return merged;
+}
+
+// Escribe "nombre": {calls, total_seconds, max_seconds} para cada temporizador
+static void writeJsonTimers(std::ostream &out, const std::vector<TimerStats> &timers)
+{
+    out << "{";
+    for (size_t i = 0; i < timers.size(); i++)
+    {
+        out << (i ? ", " : "") << "\"" << timers[i].name << "\": {\"calls\": " << timers[i].calls
+            << ", \"total_seconds\": " << timers[i].totalSeconds
+            << ", \"max_seconds\": " << timers[i].maxSeconds << "}";
+    }
+    out << "}";
+}
+
+// Escribe "nombre": valor para cada contador
+static void writeJsonCounters(std::ostream &out, const uint64_t counters[NUM_METRIC_COUNTERS])
+{
+    out << "{";
+    for (int c = 0; c < NUM_METRIC_COUNTERS; c++)
+    {
+        out << (c ? ", " : "") << "\"" << metricName(static_cast<MetricCounter>(c)) << "\": " << counters[c];
+    }
+    out << "}";
+}
+
+std::string MetricsRegistry::toJson() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    uint64_t totals[NUM_METRIC_COUNTERS] = {0};
+    for (const auto &thread : threads)
+    {
+        for (int c = 0; c < NUM_METRIC_COUNTERS; c++)
+        {
+            totals[c] += thread->counters[c];
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\n  \"counters\": ";
+    writeJsonCounters(out, totals);
+    out << ",\n  \"timers\": ";
+    writeJsonTimers(out, mergeTimers(threads));
+    out << ",\n  \"threads\": [";
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        out << (t ? "," : "") << "\n    {\"thread\": " << t << ", \"counters\": ";
+        writeJsonCounters(out, threads[t]->counters);
+        out << ", \"timers\": ";
+        writeJsonTimers(out, threads[t]->timers);
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+std::string MetricsRegistry::toPrometheus() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+
+    for (int c = 0; c < NUM_METRIC_COUNTERS; c++)
+    {
+        const char *name = metricName(static_cast<MetricCounter>(c));
+        out << "# TYPE mc_" << name << "_total counter\n";
+        for (size_t t = 0; t < threads.size(); t++)
+        {
+            out << "mc_" << name << "_total{thread=\"" << t << "\"} " << threads[t]->counters[c] << "\n";
+        }
+    }
+
+    out << "# TYPE mc_timer_calls_total counter\n";
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        for (const TimerStats &timer : threads[t]->timers)
+        {
+            out << "mc_timer_calls_total{timer=\"" << timer.name << "\",thread=\"" << t << "\"} "
+                << timer.calls << "\n";
+        }
+    }
+    out << "# TYPE mc_timer_seconds_total counter\n";
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        for (const TimerStats &timer : threads[t]->timers)
+        {
+            out << "mc_timer_seconds_total{timer=\"" << timer.name << "\",thread=\"" << t << "\"} "
+                << timer.totalSeconds << "\n";
+        }
+    }
+    out << "# TYPE mc_timer_max_seconds gauge\n";
+    for (size_t t = 0; t < threads.size(); t++)
+    {
+        for (const TimerStats &timer : threads[t]->timers)
+        {
+            out << "mc_timer_max_seconds{timer=\"" << timer.name << "\",thread=\"" << t << "\"} "
+                << timer.maxSeconds << "\n";
+        }
+    }
+    return out.str();
+}
+
+bool MetricsRegistry::writeFile(const std::string &filename) const
+{
+    auto endsWith = [&](const std::string &ext) {
+        return filename.size() >= ext.size() &&
+               filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
+    };
+
+    std::ofstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+    file << (endsWith(".prom") || endsWith(".txt") ? toPrometheus() : toJson());
+    return static_cast<bool>(file);
+}
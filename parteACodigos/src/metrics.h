@@ -0,0 +1,116 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Instrumentación de bajo coste: contadores por hilo y temporizadores RAII
+// por nombre. Se activa al compilar con -DMC_ENABLE_METRICS; sin esa opción
+// las macros MC_METRIC_ADD y MC_SCOPED_TIMER no generan código.
+
+// Contadores disponibles
+enum class MetricCounter
+{
+    CELLS_VISITED,     // cubos clasificados
+    ACTIVE_CELLS,      // cubos atravesados por la isosuperficie
+    TRIANGLES_EMITTED, // triángulos generados
+    BYTES_READ,        // bytes leídos de disco
+    BYTES_WRITTEN      // bytes escritos a disco
+};
+
+const int NUM_METRIC_COUNTERS = 5;
+
+// Nombre del contador en la exportación (p. ej. "cells_visited")
+const char *metricName(MetricCounter counter);
+
+// Tiempo acumulado de un temporizador
+struct TimerStats
+{
+    const char *name;
+    long long calls;
+    double totalSeconds;
+    double maxSeconds;
+};
+
+// Métricas de un hilo: solo ese hilo escribe en ellas
+struct ThreadMetrics
+{
+    uint64_t counters[NUM_METRIC_COUNTERS];
+    std::vector<TimerStats> timers;
+
+    ThreadMetrics();
+
+    void add(MetricCounter counter, uint64_t value) { counters[static_cast<int>(counter)] += value; }
+    void addTime(const char *name, double seconds);
+};
+
+// Registro global con las métricas de todos los hilos que han participado.
+// Las exportaciones y reset deben llamarse sin extracciones en curso
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry &instance();
+
+    // Métricas del hilo que llama (se crean en su primer uso y sobreviven
+    // al hilo)
+    ThreadMetrics &local();
+
+    // Pone a cero todos los contadores y temporizadores
+    void reset();
+
+    // Exportación en JSON (totales y desglose por hilo) o en el formato de
+    // texto de Prometheus (una serie por hilo con la etiqueta "thread")
+    std::string toJson() const;
+    std::string toPrometheus() const;
+
+    // Escribe el formato según la extensión: .prom o .txt para Prometheus,
+    // JSON en otro caso
+    bool writeFile(const std::string &filename) const;
+
+private:
+    MetricsRegistry() {}
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadMetrics>> threads;
+};
+
+// Temporizador de ámbito: acumula en 'name' el tiempo hasta su destrucción.
+// 'name' debe ser una cadena literal (se guarda el puntero)
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char *timerName)
+        : name(timerName), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer()
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        MetricsRegistry::instance().local().addTime(name, elapsed.count());
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define MC_METRICS_CONCAT_(a, b) a##b
+#define MC_METRICS_CONCAT(a, b) MC_METRICS_CONCAT_(a, b)
+
+#ifdef MC_ENABLE_METRICS
+#define MC_METRIC_ADD(counter, value) \
+    MetricsRegistry::instance().local().add(MetricCounter::counter, static_cast<uint64_t>(value))
+#define MC_SCOPED_TIMER(name) \
+    ScopedTimer MC_METRICS_CONCAT(scopedTimer_, __LINE__)(name)
+#else
+#define MC_METRIC_ADD(counter, value) ((void)sizeof(value))
+#define MC_SCOPED_TIMER(name) ((void)0)
+#endif
+
+#endif // METRICS_H
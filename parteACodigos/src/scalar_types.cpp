@@ -0,0 +1,70 @@
+#include "scalar_types.h"
+#include <algorithm>
+#include <limits>
+
+// Cuantización lineal al rango completo [0, Levels - 1]
+template <typename T, int Levels>
+static void quantizeLinear(const float *data, size_t count, std::vector<T> &out,
+                           float &scale, float &offset)
+{
+    out.resize(count);
+
+    float lo = std::numeric_limits<float>::max();
+    float hi = std::numeric_limits<float>::lowest();
+    const long long n = static_cast<long long>(count);
+
+#pragma omp parallel for simd reduction(min : lo) reduction(max : hi) schedule(static)
+    for (long long i = 0; i < n; i++)
+    {
+        lo = std::min(lo, data[i]);
+        hi = std::max(hi, data[i]);
+    }
+
+    if (count == 0 || !(hi > lo))
+    {
+        // Campo vacío o constante: todo se guarda como 0
+        scale = 1.0f;
+        offset = count ? lo : 0.0f;
+        std::fill(out.begin(), out.end(), T(0));
+        return;
+    }
+
+    scale = (hi - lo) / (Levels - 1);
+    offset = lo;
+    const float inverse = 1.0f / scale;
+    T *dst = out.data();
+
+#pragma omp parallel for simd schedule(static)
+    for (long long i = 0; i < n; i++)
+    {
+        float q = (data[i] - lo) * inverse + 0.5f;
+        q = std::min(std::max(q, 0.0f), static_cast<float>(Levels - 1));
+        dst[i] = static_cast<T>(q);
+    }
+}
+
+void quantizeField(const float *data, size_t count, std::vector<uint8_t> &out,
+                   float &scale, float &offset)
+{
+    quantizeLinear<uint8_t, 256>(data, count, out, scale, offset);
+}
+
+void quantizeField(const float *data, size_t count, std::vector<uint16_t> &out,
+                   float &scale, float &offset)
+{
+    quantizeLinear<uint16_t, 65536>(data, count, out, scale, offset);
+}
+
+// Convierte a half elemento a elemento
+void convertToHalf(const float *data, size_t count, std::vector<Half> &out)
+{
+    out.resize(count);
+    Half *dst = out.data();
+    const long long n = static_cast<long long>(count);
+
+#pragma omp parallel for schedule(static)
+    for (long long i = 0; i < n; i++)
+    {
+        dst[i] = floatToHalf(data[i]);
+    }
+}
@@ -0,0 +1,203 @@
+#ifndef SCALAR_TYPES_H
+#define SCALAR_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+// Tipos de almacenamiento reducido para los vóxeles.
+//
+// Los datos de escáner tienen 8-12 bits de precisión, así que guardarlos como
+// float de 4 bytes desperdicia ancho de banda. Además de float se admiten
+// uint8_t y uint16_t (con escala y desplazamiento: real = guardado * scale +
+// offset) y Half (IEEE 754 binary16).
+//
+// La clasificación de los cubos no convierte cada vóxel a float: el isovalor
+// se traduce una vez al dominio almacenado (ScalarTraits<T>::threshold) y cada
+// esquina se compara como entero (o float, si el tipo es float).
+
+// Número en coma flotante de 16 bits (1 signo, 5 exponente, 10 mantisa)
+struct Half
+{
+    uint16_t bits;
+};
+
+// Conversión exacta de half a float
+inline float halfToFloat(Half h)
+{
+    uint32_t sign = static_cast<uint32_t>(h.bits & 0x8000) << 16;
+    uint32_t exponent = (h.bits >> 10) & 0x1F;
+    uint32_t mantissa = h.bits & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0x1F)
+    {
+        // Infinito o NaN
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0)
+    {
+        bits = sign;
+    }
+    else
+    {
+        // Subnormal: normalizar la mantisa
+        exponent = 113;
+        while (!(mantissa & 0x400))
+        {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Conversión de float a half con redondeo al par más cercano
+inline Half floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    int exponent = static_cast<int>((bits >> 23) & 0xFF);
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent == 0xFF)
+    {
+        // Infinito o NaN (el NaN conserva un bit de mantisa)
+        return Half{static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0))};
+    }
+
+    int halfExponent = exponent - 112;
+    if (halfExponent >= 0x1F)
+    {
+        return Half{static_cast<uint16_t>(sign | 0x7C00)};
+    }
+
+    if (halfExponent <= 0)
+    {
+        // Subnormal o cero
+        if (halfExponent < -10)
+        {
+            return Half{sign};
+        }
+        mantissa |= 0x800000;
+        int shift = 14 - halfExponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+        {
+            half++;
+        }
+        return Half{static_cast<uint16_t>(sign | half)};
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+    {
+        // El acarreo puede pasar al exponente (y llegar a infinito): es correcto
+        half++;
+    }
+    return Half{static_cast<uint16_t>(sign | half)};
+}
+
+// Rasgos de cada tipo almacenado:
+// - Key: tipo en el que se comparan las esquinas con el umbral
+// - key(v): clave de un valor, monótona con su valor real
+// - threshold(s): clave mínima de los valores >= s, de modo que
+//   v < s  <=>  key(v) < threshold(s)
+// - toFloat(v): valor almacenado como float (antes de escala y desplazamiento)
+template <typename T>
+struct ScalarTraits;
+
+template <>
+struct ScalarTraits<float>
+{
+    typedef float Key;
+    static const char *name() { return "float32"; }
+    static Key key(float v) { return v; }
+    static Key threshold(float stored) { return stored; }
+    static float toFloat(float v) { return v; }
+};
+
+// Enteros sin signo: v < s  <=>  v < ceil(s), limitado al rango del tipo
+template <typename T, int Levels>
+struct UnsignedScalarTraits
+{
+    typedef int Key;
+    static Key key(T v) { return v; }
+    static Key threshold(float stored)
+    {
+        double t = std::ceil(static_cast<double>(stored));
+        if (!(t > 0.0))
+        {
+            return 0;
+        }
+        return t > Levels ? Levels : static_cast<int>(t);
+    }
+    static float toFloat(T v) { return static_cast<float>(v); }
+};
+
+template <>
+struct ScalarTraits<uint8_t> : UnsignedScalarTraits<uint8_t, 256>
+{
+    static const char *name() { return "uint8"; }
+};
+
+template <>
+struct ScalarTraits<uint16_t> : UnsignedScalarTraits<uint16_t, 65536>
+{
+    static const char *name() { return "uint16"; }
+};
+
+// Half: los bits se transforman en un entero de 16 bits ordenado como el
+// valor (negativos invertidos, positivos desplazados por encima). -0 y +0
+// reciben claves consecutivas; el umbral de 0 se sitúa en -0 para que
+// ninguno de los dos cuente como menor
+template <>
+struct ScalarTraits<Half>
+{
+    typedef int Key;
+    static const char *name() { return "float16"; }
+    static Key key(Half v)
+    {
+        int sign = static_cast<int16_t>(v.bits) >> 15;
+        return v.bits ^ ((sign & 0x7FFF) | 0x8000);
+    }
+    static Key threshold(float stored)
+    {
+        Half h = floatToHalf(stored);
+        int k = key(h);
+        if (halfToFloat(h) < stored)
+        {
+            k++;
+        }
+        return k == 0x8000 ? 0x7FFF : k;
+    }
+    static float toFloat(Half v) { return halfToFloat(v); }
+};
+
+// Cuantiza 'count' valores a enteros de 8 o 16 bits usando todo el rango del
+// tipo entre el mínimo y el máximo del campo. Devuelve en scale y offset la
+// correspondencia real = guardado * scale + offset
+void quantizeField(const float *data, size_t count, std::vector<uint8_t> &out,
+                   float &scale, float &offset);
+void quantizeField(const float *data, size_t count, std::vector<uint16_t> &out,
+                   float &scale, float &offset);
+
+// Convierte 'count' valores a half (escala 1, desplazamiento 0)
+void convertToHalf(const float *data, size_t count, std::vector<Half> &out);
+
+#endif // SCALAR_TYPES_H
@@ -1,20 +1,46 @@
 #include "generate_data.h"
+#include "metrics.h"
 #include <iostream>
+#include <string>
 
-int main()
+// Uso: generator [--stress tamaño] [metricas.json|metricas.prom]
+int main(int argc, char *argv[])
 {
-    std::cout << "=== GENERADOR DE DATOS DE PRUEBA PARA MARCHING CUBES ===" << std::endl;
-    std::cout << "Versión segura y optimizada" << std::endl;
+    int stressSize = 0;
+    std::string metricsPath;
 
     try
     {
+        // Dentro del try: un tamaño no numérico termina con un mensaje
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--stress" && i + 1 < argc)
+            {
+                stressSize = std::stoi(argv[++i]);
+            }
+            else
+            {
+                metricsPath = arg;
+            }
+        }
+
+        std::cout << "=== GENERADOR DE DATOS DE PRUEBA PARA MARCHING CUBES ===" << std::endl;
+        std::cout << "Versión segura y optimizada" << std::endl;
+
         // Generar todos los datasets de prueba
         generateTestDatasets();
 
+        // Familia de estrés (densidad y agrupamiento variables)
+        if (stressSize > 0)
+        {
+            generateStressDatasets(stressSize);
+        }
+
         std::cout << "\n=== PRUEBA DE CARGA ===" << std::endl;
 
         // Probar cargar el dataset más pequeño
-        std::vector<std::vector<std::vector<float>>> loaded_field;
+        Volume loaded_field;
         int nx, ny, nz;
 
         if (loadFieldBinary(loaded_field, "test_sphere_32.bin", nx, ny, nz))
@@ -39,5 +65,11 @@ int main()
     std::cout << "- Iso-value recomendado: 0.0 (para esferas)" << std::endl;
     std::cout << "- Iso-value recomendado: 5.0 (para ondas)" << std::endl;
 
+    // Métricas de generación, guardado y carga (requiere -DMC_ENABLE_METRICS)
+    if (!metricsPath.empty() && !MetricsRegistry::instance().writeFile(metricsPath))
+    {
+        return 1;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "volume.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+// Constructores
+Volume::Volume()
+    : values(nullptr), sizeX(0), sizeY(0), sizeZ(0)
+{
+}
+
+Volume::Volume(int nx, int ny, int nz)
+    : values(nullptr), sizeX(0), sizeY(0), sizeZ(0)
+{
+    allocate(nx, ny, nz);
+}
+
+// Destructor
+Volume::~Volume()
+{
+    release();
+}
+
+Volume::Volume(Volume &&other) noexcept
+    : values(other.values), sizeX(other.sizeX), sizeY(other.sizeY), sizeZ(other.sizeZ)
+{
+    other.values = nullptr;
+    other.sizeX = other.sizeY = other.sizeZ = 0;
+}
+
+Volume &Volume::operator=(Volume &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        std::swap(values, other.values);
+        std::swap(sizeX, other.sizeX);
+        std::swap(sizeY, other.sizeY);
+        std::swap(sizeZ, other.sizeZ);
+    }
+    return *this;
+}
+
+// Reserva un único bloque alineado para todo el volumen
+bool Volume::allocate(int nx, int ny, int nz)
+{
+    release();
+
+    if (nx <= 0 || ny <= 0 || nz <= 0)
+    {
+        return false;
+    }
+
+    size_t count = static_cast<size_t>(nx) * ny * nz;
+
+    // aligned_alloc exige que el tamaño sea múltiplo de la alineación
+    size_t bytes = count * sizeof(float);
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    values = static_cast<float *>(std::aligned_alloc(ALIGNMENT, bytes));
+    if (!values)
+    {
+        return false;
+    }
+
+    sizeX = nx;
+    sizeY = ny;
+    sizeZ = nz;
+    return true;
+}
+
+// Libera la memoria
+void Volume::release()
+{
+    std::free(values);
+    values = nullptr;
+    sizeX = sizeY = sizeZ = 0;
+}
+
+// Asigna el mismo valor a todos los elementos
+void Volume::fill(float value)
+{
+    // Por planos z y en paralelo: cada hilo toca primero (y por tanto ubica
+    // en su nodo NUMA) los mismos planos que luego generan los generadores
+    const int planes = sizeZ;
+    const size_t planeSize = strideZ();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int z = 0; z < planes; ++z)
+    {
+        std::fill(values + z * planeSize, values + (z + 1) * planeSize, value);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef VOLUME_H
+#define VOLUME_H
+
+#include <cstddef>
+
+// Volumen escalar 3D almacenado en un único bloque contiguo alineado a 64 bytes.
+//
+// Orden en memoria (el mismo que espera MarchingCubesSerial::setScalarField
+// y el que se usa en los archivos .bin): x es el índice más rápido, luego y,
+// luego z:
+//
+//     index(x, y, z) = z * strideZ() + y * strideY() + x
+//     strideY() = nx,  strideZ() = nx * ny
+class Volume
+{
+public:
+    static const size_t ALIGNMENT = 64;
+
+    // Constructores
+    Volume();
+    Volume(int nx, int ny, int nz);
+
+    // Destructor
+    ~Volume();
+
+    // Solo movible: copiar un volumen completo debe ser explícito
+    Volume(Volume &&other) noexcept;
+    Volume &operator=(Volume &&other) noexcept;
+    Volume(const Volume &) = delete;
+    Volume &operator=(const Volume &) = delete;
+
+    // Reserva (sin inicializar) un volumen de nx*ny*nz valores.
+    // Devuelve false si no hay memoria suficiente
+    bool allocate(int nx, int ny, int nz);
+
+    // Libera la memoria
+    void release();
+
+    // Dimensiones
+    int nx() const { return sizeX; }
+    int ny() const { return sizeY; }
+    int nz() const { return sizeZ; }
+
+    // Strides en número de elementos
+    size_t strideY() const { return static_cast<size_t>(sizeX); }
+    size_t strideZ() const { return static_cast<size_t>(sizeX) * sizeY; }
+
+    // Total de elementos y de bytes
+    size_t size() const { return strideZ() * sizeZ; }
+    size_t bytes() const { return size() * sizeof(float); }
+    bool empty() const { return values == nullptr; }
+
+    // Índice lineal de (x, y, z)
+    size_t index(int x, int y, int z) const
+    {
+        return static_cast<size_t>(z) * strideZ() + static_cast<size_t>(y) * strideY() + x;
+    }
+
+    // Acceso a los valores
+    float &operator()(int x, int y, int z) { return values[index(x, y, z)]; }
+    float operator()(int x, int y, int z) const { return values[index(x, y, z)]; }
+
+    // Puntero al primer elemento del plano z / de la fila (y, z)
+    float *slice(int z) { return values + static_cast<size_t>(z) * strideZ(); }
+    const float *slice(int z) const { return values + static_cast<size_t>(z) * strideZ(); }
+    float *row(int y, int z) { return values + index(0, y, z); }
+    const float *row(int y, int z) const { return values + index(0, y, z); }
+
+    // Datos crudos (válidos para setScalarField)
+    float *data() { return values; }
+    const float *data() const { return values; }
+
+    // Asigna el mismo valor a todos los elementos
+    void fill(float value);
+
+private:
+    float *values;
+    int sizeX, sizeY, sizeZ;
+};
+
+#endif // VOLUME_H
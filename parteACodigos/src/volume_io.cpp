@@ -0,0 +1,329 @@
+#include "volume_io.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Alineación de bloque exigida por O_DIRECT
+static const size_t BLOCK_SIZE = 4096;
+
+static size_t roundUp(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+static int ioThreads(const VolumeIOOptions &options)
+{
+    if (options.threads > 0)
+    {
+        return options.threads;
+    }
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// pread/pwrite completos: repiten hasta transferir 'length' bytes
+static bool preadAll(int fd, char *dest, size_t length, off_t offset)
+{
+    while (length > 0)
+    {
+        ssize_t got = pread(fd, dest, length, offset);
+        if (got <= 0)
+        {
+            return false;
+        }
+        dest += got;
+        offset += got;
+        length -= got;
+    }
+    return true;
+}
+
+static bool pwriteAll(int fd, const char *src, size_t length, off_t offset)
+{
+    while (length > 0)
+    {
+        ssize_t put = pwrite(fd, src, length, offset);
+        if (put <= 0)
+        {
+            return false;
+        }
+        src += put;
+        offset += put;
+        length -= put;
+    }
+    return true;
+}
+
+// Abre con O_DIRECT si se pide y es posible; si no, con E/S normal
+static int openFile(const std::string &filename, int flags, bool directIO, bool &usingDirect)
+{
+    usingDirect = false;
+#ifdef O_DIRECT
+    if (directIO)
+    {
+        int fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+        if (fd >= 0)
+        {
+            usingDirect = true;
+            return fd;
+        }
+        std::cerr << "Aviso: O_DIRECT no disponible para " << filename << ", usando E/S normal" << std::endl;
+    }
+#else
+    (void)directIO;
+#endif
+    return ::open(filename.c_str(), flags, 0644);
+}
+
+// Buffer alineado de un hilo para O_DIRECT
+struct AlignedBuffer
+{
+    char *data;
+
+    explicit AlignedBuffer(size_t bytes)
+        : data(static_cast<char *>(std::aligned_alloc(BLOCK_SIZE, roundUp(bytes, BLOCK_SIZE)))) {}
+    ~AlignedBuffer() { std::free(data); }
+
+    AlignedBuffer(const AlignedBuffer &) = delete;
+    AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+};
+
+// Escribe el volumen por bloques independientes en paralelo
+bool writeVolumeFile(const Volume &field, const std::string &filename, const VolumeIOOptions &options)
+{
+    if (field.empty())
+    {
+        std::cerr << "Error: Campo vacío" << std::endl;
+        return false;
+    }
+
+    bool direct = false;
+    int fd = openFile(filename, O_WRONLY | O_CREAT | O_TRUNC, options.directIO, direct);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para escribir." << std::endl;
+        return false;
+    }
+
+    const int header[3] = {field.nx(), field.ny(), field.nz()};
+    const char *payload = reinterpret_cast<const char *>(field.data());
+    const size_t fileSize = VOLUME_HEADER_SIZE + field.bytes();
+    const size_t chunk = roundUp(std::max<size_t>(options.chunkBytes, BLOCK_SIZE), BLOCK_SIZE);
+    const long long numChunks = static_cast<long long>((fileSize + chunk - 1) / chunk);
+    std::atomic<bool> failed(false);
+
+    if (!direct)
+    {
+        // Cabecera y datos directamente desde el volumen (sin copias)
+        failed = !pwriteAll(fd, reinterpret_cast<const char *>(header), VOLUME_HEADER_SIZE, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(ioThreads(options))
+#endif
+        for (long long c = 0; c < numChunks; c++)
+        {
+            size_t begin = std::min(static_cast<size_t>(c) * chunk, field.bytes());
+            size_t end = std::min(begin + chunk, field.bytes());
+            if (begin < end && !pwriteAll(fd, payload + begin, end - begin, VOLUME_HEADER_SIZE + begin))
+            {
+                failed = true;
+            }
+        }
+    }
+    else
+    {
+        // O_DIRECT: cada bloque del archivo se compone en un buffer alineado
+        // (la cabecera de 12 bytes desalinea los datos) y el último se
+        // rellena hasta el tamaño de bloque; ftruncate ajusta el tamaño final
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ioThreads(options))
+#endif
+        {
+            AlignedBuffer buffer(chunk);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+            for (long long c = 0; c < numChunks; c++)
+            {
+                size_t begin = static_cast<size_t>(c) * chunk;
+                size_t end = std::min(begin + chunk, fileSize);
+                char *out = buffer.data;
+                if (!out)
+                {
+                    failed = true;
+                    continue;
+                }
+
+                if (begin < VOLUME_HEADER_SIZE)
+                {
+                    std::memcpy(out, reinterpret_cast<const char *>(header) + begin, VOLUME_HEADER_SIZE - begin);
+                    std::memcpy(out + VOLUME_HEADER_SIZE - begin, payload, end - VOLUME_HEADER_SIZE);
+                }
+                else
+                {
+                    std::memcpy(out, payload + (begin - VOLUME_HEADER_SIZE), end - begin);
+                }
+
+                size_t length = roundUp(end - begin, BLOCK_SIZE);
+                std::memset(out + (end - begin), 0, length - (end - begin));
+                if (!pwriteAll(fd, out, length, begin))
+                {
+                    failed = true;
+                }
+            }
+        }
+
+        if (ftruncate(fd, fileSize) != 0)
+        {
+            failed = true;
+        }
+    }
+
+    if (::close(fd) != 0 || failed)
+    {
+        std::cerr << "Error: Escritura fallida en " << filename << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Lee la cabecera y valida el tamaño del archivo
+bool readVolumeHeader(const std::string &filename, int &nx, int &ny, int &nz)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
+        return false;
+    }
+
+    int header[3];
+    struct stat info;
+    bool ok = preadAll(fd, reinterpret_cast<char *>(header), VOLUME_HEADER_SIZE, 0) && fstat(fd, &info) == 0;
+    ::close(fd);
+
+    if (!ok || header[0] <= 0 || header[1] <= 0 || header[2] <= 0 ||
+        static_cast<size_t>(info.st_size) !=
+            VOLUME_HEADER_SIZE + static_cast<size_t>(header[0]) * header[1] * header[2] * sizeof(float))
+    {
+        std::cerr << "Error: Cabecera o tamaño incorrectos en " << filename << std::endl;
+        return false;
+    }
+
+    nx = header[0];
+    ny = header[1];
+    nz = header[2];
+    return true;
+}
+
+// Lee el volumen por bloques independientes en paralelo
+bool readVolumeFile(Volume &field, const std::string &filename, const VolumeIOOptions &options)
+{
+    int nx, ny, nz;
+    if (!readVolumeHeader(filename, nx, ny, nz))
+    {
+        return false;
+    }
+    if (!field.allocate(nx, ny, nz))
+    {
+        std::cerr << "Error de memoria al cargar " << filename << std::endl;
+        return false;
+    }
+
+    bool direct = false;
+    int fd = openFile(filename, O_RDONLY, options.directIO, direct);
+    if (fd < 0)
+    {
+        std::cerr << "Error: No se pudo abrir " << filename << " para leer." << std::endl;
+        field.release();
+        return false;
+    }
+
+    char *payload = reinterpret_cast<char *>(field.data());
+    const size_t fileSize = VOLUME_HEADER_SIZE + field.bytes();
+    const size_t chunk = roundUp(std::max<size_t>(options.chunkBytes, BLOCK_SIZE), BLOCK_SIZE);
+    const long long numChunks = static_cast<long long>((fileSize + chunk - 1) / chunk);
+    std::atomic<bool> failed(false);
+
+    if (!direct)
+    {
+        // Directamente sobre el volumen; cada hilo toca primero sus páginas
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(ioThreads(options))
+#endif
+        for (long long c = 0; c < numChunks; c++)
+        {
+            size_t begin = std::min(static_cast<size_t>(c) * chunk, field.bytes());
+            size_t end = std::min(begin + chunk, field.bytes());
+            if (begin < end && !preadAll(fd, payload + begin, end - begin, VOLUME_HEADER_SIZE + begin))
+            {
+                failed = true;
+            }
+        }
+    }
+    else
+    {
+        // O_DIRECT: bloques alineados del archivo a un buffer alineado y
+        // copia de la parte de datos al volumen
+#ifdef _OPENMP
+#pragma omp parallel num_threads(ioThreads(options))
+#endif
+        {
+            AlignedBuffer buffer(chunk);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1)
+#endif
+            for (long long c = 0; c < numChunks; c++)
+            {
+                size_t begin = static_cast<size_t>(c) * chunk;
+                size_t end = std::min(begin + chunk, fileSize);
+                char *in = buffer.data;
+
+                // El último bloque se pide completo: pread devuelve menos
+                // bytes al llegar al final del archivo
+                size_t length = roundUp(end - begin, BLOCK_SIZE);
+                size_t done = 0;
+                while (buffer.data && done < end - begin)
+                {
+                    ssize_t got = pread(fd, in + done, length - done, begin + done);
+                    if (got <= 0)
+                    {
+                        break;
+                    }
+                    done += got;
+                }
+                if (done < end - begin)
+                {
+                    failed = true;
+                    continue;
+                }
+
+                size_t skip = begin < VOLUME_HEADER_SIZE ? VOLUME_HEADER_SIZE - begin : 0;
+                std::memcpy(payload + (begin + skip - VOLUME_HEADER_SIZE), in + skip, end - begin - skip);
+            }
+        }
+    }
+
+    ::close(fd);
+    if (failed)
+    {
+        std::cerr << "Error: Archivo truncado " << filename << std::endl;
+        field.release();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef VOLUME_IO_H
+#define VOLUME_IO_H
+
+#include <cstddef>
+#include <string>
+#include "volume.h"
+
+// Tamaño de la cabecera de los archivos .bin (nx, ny, nz)
+static const size_t VOLUME_HEADER_SIZE = 3 * sizeof(int);
+
+// Opciones de la E/S masiva de archivos .bin (cabecera nx, ny, nz + floats)
+struct VolumeIOOptions
+{
+    // Hilos que leen/escriben bloques independientes con pread/pwrite
+    // (0 = valor por defecto de OpenMP)
+    int threads;
+
+    // Tamaño de cada bloque de E/S (se redondea a múltiplo de 4 KB)
+    size_t chunkBytes;
+
+    // Usar O_DIRECT (sin pasar por la caché de páginas). Si el sistema de
+    // archivos no lo admite se usa la E/S normal
+    bool directIO;
+
+    VolumeIOOptions() : threads(0), chunkBytes(8u << 20), directIO(false) {}
+};
+
+// Escribe 'field' en 'filename'. Devuelve false si hubo algún error
+bool writeVolumeFile(const Volume &field, const std::string &filename,
+                     const VolumeIOOptions &options = VolumeIOOptions());
+
+// Lee 'filename' en 'field' (que se redimensiona). Comprueba que el tamaño
+// del archivo coincide con la cabecera
+bool readVolumeFile(Volume &field, const std::string &filename,
+                    const VolumeIOOptions &options = VolumeIOOptions());
+
+// Lee solo la cabecera (nx, ny, nz) y comprueba el tamaño del archivo
+bool readVolumeHeader(const std::string &filename, int &nx, int &ny, int &nz);
+
+#endif // VOLUME_IO_H
@@ -0,0 +1,183 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+
+// Crea los hilos auxiliares (el trabajador 0 es quien llama a run)
+WorkStealingPool::WorkStealingPool(int numWorkers)
+    : workers(std::max(1, numWorkers)), queues(new TaskRange[std::max(1, numWorkers)]),
+      workerStats(std::max(1, numWorkers)), currentTask(nullptr), remaining(0), runMs(0.0),
+      generation(0), running(0), stopping(false)
+{
+    for (int w = 0; w < workers; w++)
+    {
+        queues[w].range.store(0, std::memory_order_relaxed);
+    }
+    for (int w = 1; w < workers; w++)
+    {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, w);
+    }
+}
+
+// Despierta a los hilos para que terminen y los espera
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : threads)
+    {
+        t.join();
+    }
+}
+
+// Toma la primera tarea del tramo propio
+bool WorkStealingPool::popLocal(int worker, int &task)
+{
+    std::atomic<uint64_t> &range = queues[worker].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    for (;;)
+    {
+        uint32_t begin = static_cast<uint32_t>(current >> 32);
+        uint32_t end = static_cast<uint32_t>(current);
+        if (begin >= end)
+        {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, pack(begin + 1, end), std::memory_order_acq_rel))
+        {
+            task = static_cast<int>(begin);
+            return true;
+        }
+    }
+}
+
+// Roba la mitad final del tramo de otro trabajador y la hace propia. Solo se
+// llama con el tramo propio vacío, y nadie más escribe en un tramo vacío
+bool WorkStealingPool::steal(int worker, uint32_t &seed)
+{
+    // Generador xorshift propio de cada trabajador para elegir la víctima
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    const int first = static_cast<int>(seed % workers);
+
+    for (int i = 0; i < workers; i++)
+    {
+        int victim = (first + i) % workers;
+        if (victim == worker)
+        {
+            continue;
+        }
+
+        std::atomic<uint64_t> &range = queues[victim].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        for (;;)
+        {
+            uint32_t begin = static_cast<uint32_t>(current >> 32);
+            uint32_t end = static_cast<uint32_t>(current);
+            if (begin >= end)
+            {
+                break;
+            }
+            uint32_t take = (end - begin + 1) / 2;
+            if (range.compare_exchange_weak(current, pack(begin, end - take), std::memory_order_acq_rel))
+            {
+                queues[worker].range.store(pack(end - take, end), std::memory_order_release);
+                workerStats[worker].steals++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Bucle de un trabajador durante una ejecución
+void WorkStealingPool::work(int worker)
+{
+    WorkerStats &stats = workerStats[worker];
+    uint32_t seed = 0x9E3779B9u * static_cast<uint32_t>(worker + 1);
+    int task;
+
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (popLocal(worker, task))
+        {
+            auto start = std::chrono::steady_clock::now();
+            (*currentTask)(worker, task);
+            auto end = std::chrono::steady_clock::now();
+
+            stats.busyMs += std::chrono::duration<double, std::milli>(end - start).count();
+            stats.tasks++;
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        else if (!steal(worker, seed))
+        {
+            // Quedan tareas, pero todas están en ejecución
+            std::this_thread::yield();
+        }
+    }
+}
+
+// Hilo auxiliar: espera cada ejecución y participa en ella
+void WorkStealingPool::workerLoop(int worker)
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+            {
+                return;
+            }
+            seen = generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0)
+            {
+                done.notify_one();
+            }
+        }
+    }
+}
+
+// Reparte las tareas en tramos contiguos y trabaja hasta que no queda ninguna
+void WorkStealingPool::run(int numTasks, const std::function<void(int, int)> &task)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::fill(workerStats.begin(), workerStats.end(), WorkerStats());
+
+    if (numTasks > 0)
+    {
+        currentTask = &task;
+        remaining.store(numTasks, std::memory_order_relaxed);
+        for (int w = 0; w < workers; w++)
+        {
+            uint32_t begin = static_cast<uint32_t>(static_cast<long long>(numTasks) * w / workers);
+            uint32_t end = static_cast<uint32_t>(static_cast<long long>(numTasks) * (w + 1) / workers);
+            queues[w].range.store(pack(begin, end), std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = workers - 1;
+            generation++;
+        }
+        wake.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return running == 0; });
+        currentTask = nullptr;
+    }
+
+    runMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,86 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Grupo de hilos persistente que reparte tareas con robo de trabajo.
+//
+// run(numTasks, task) ejecuta task(worker, i) una vez por cada i en
+// [0, numTasks). Cada trabajador empieza con un tramo contiguo de tareas y
+// las consume desde el principio. Cuando se queda sin trabajo roba la mitad
+// final del tramo de otro trabajador, empezando por uno elegido al azar. Así
+// los trabajadores que terminan pronto (p. ej. slabs vacíos) ayudan a los
+// que tienen la superficie hasta que se acaba la última tarea.
+//
+// Cada tramo es un único entero atómico de 64 bits (inicio, fin): tomar o
+// robar tareas es un compare-and-swap, sin cerrojos. El hilo que llama a
+// run() actúa como trabajador 0; los demás hilos se crean una sola vez y
+// esperan entre ejecuciones.
+class WorkStealingPool
+{
+public:
+    // Estadísticas de un trabajador en la última ejecución
+    struct WorkerStats
+    {
+        long long tasks = 0;  // tareas ejecutadas
+        long long steals = 0; // robos con éxito
+        double busyMs = 0.0;  // tiempo dentro de las tareas
+    };
+
+    explicit WorkStealingPool(int numWorkers);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int numWorkers() const { return workers; }
+
+    // Ejecuta todas las tareas y vuelve cuando han terminado
+    void run(int numTasks, const std::function<void(int worker, int task)> &task);
+
+    // Estadísticas y duración de la última ejecución
+    const std::vector<WorkerStats> &stats() const { return workerStats; }
+    double lastRunMs() const { return runMs; }
+
+private:
+    // Tramo [inicio, fin) de un trabajador, en su propia línea de caché
+    struct alignas(64) TaskRange
+    {
+        std::atomic<uint64_t> range;
+    };
+
+    static uint64_t pack(uint32_t begin, uint32_t end)
+    {
+        return (static_cast<uint64_t>(begin) << 32) | end;
+    }
+
+    bool popLocal(int worker, int &task);
+    bool steal(int worker, uint32_t &seed);
+    void work(int worker);
+    void workerLoop(int worker);
+
+    int workers;
+    std::unique_ptr<TaskRange[]> queues;
+    std::vector<WorkerStats> workerStats;
+    const std::function<void(int, int)> *currentTask;
+    std::atomic<long long> remaining;
+    double runMs;
+
+    // Arranque y fin de cada ejecución
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation;
+    int running;
+    bool stopping;
+};
+
+#endif // WORK_STEALING_POOL_H